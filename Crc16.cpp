@@ -0,0 +1,112 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#include "Crc16.h"
+
+#define CRC16_POLY	0x1021
+
+// CRC of v followed by n null bytes
+static quint16 zeros(const quint16 *t0, quint16 v, int n)
+{
+	for(int i = 0 ; i < n ; ++i) {
+		v = t0[v >> 8] ^ quint16(v << 8);
+	}
+	return v;
+}
+
+Crc16::Tables::Tables()
+{
+	for(int b = 0 ; b < 256 ; ++b) {
+		quint16 crc = quint16(b << 8);
+		for(int bit = 0 ; bit < 8 ; ++bit) {
+			crc = crc & 0x8000 ? quint16((crc << 1) ^ CRC16_POLY) : quint16(crc << 1);
+		}
+		t[0][b] = crc;
+	}
+
+	for(int k = 1 ; k < 8 ; ++k) {
+		for(int b = 0 ; b < 256 ; ++b) {
+			t[k][b] = quint16(t[k - 1][b] << 8) ^ t[0][t[k - 1][b] >> 8];
+		}
+	}
+
+	// With the real table, the index used at the byte k of a block is
+	// hi(CRC after k bytes) ^ byte k, the CRC being linear:
+	// contribution of the initial CRC + contribution of each previous byte
+	for(int b = 0 ; b < 256 ; ++b) {
+		indexHi[b] = indexLo[b] = 0;
+		for(int k = 0 ; k < 8 ; ++k) {
+			indexHi[b] |= quint64(zeros(t[0], quint16(b << 8), k) >> 8) << (8 * k);
+			indexLo[b] |= quint64(zeros(t[0], quint16(b), k) >> 8) << (8 * k);
+		}
+		for(int j = 0 ; j < 8 ; ++j) {
+			index[j][b] = quint64(b) << (8 * j);
+			for(int k = j + 1 ; k < 8 ; ++k) {
+				index[j][b] |= quint64(zeros(t[0], t[0][b], k - j - 1) >> 8) << (8 * k);
+			}
+		}
+	}
+}
+
+const Crc16::Tables &Crc16::tables()
+{
+	static const Tables tables;
+	return tables;
+}
+
+quint16 Crc16::ff8Bytewise(const char *data, qint64 size, quint16 crc)
+{
+	const quint16 *t0 = tables().t[0];
+	const quint8 *p = (const quint8 *)data;
+
+	for( ; size > 0 ; --size, ++p) {
+		const quint8 i = quint8(crc >> 8) ^ *p;
+		crc = (i == 0xFF ? 0 : t0[i]) ^ quint16(crc << 8);
+	}
+
+	return crc;
+}
+
+/*
+ * Slicing-by-8, valid as long as the entry 0xFF is not used. The eight
+ * indexes of a block are computed at once from the CRC and the bytes,
+ * without depending on each other: when one of them is 0xFF (one byte
+ * out of 256 on average), the block is computed byte by byte.
+ */
+quint16 Crc16::ff8(const char *data, qint64 size, quint16 crc)
+{
+	const Tables &tb = tables();
+	const quint16 (*t)[256] = tb.t;
+	const quint8 *p = (const quint8 *)data;
+
+	for( ; size >= 8 ; size -= 8, p += 8) {
+		const quint64 indexes = tb.indexHi[crc >> 8] ^ tb.indexLo[crc & 0xFF]
+		        ^ tb.index[0][p[0]] ^ tb.index[1][p[1]] ^ tb.index[2][p[2]] ^ tb.index[3][p[3]]
+		        ^ tb.index[4][p[4]] ^ tb.index[5][p[5]] ^ tb.index[6][p[6]] ^ tb.index[7][p[7]];
+		const quint64 inverted = ~indexes; // One null byte if an index is 0xFF
+
+		if(Q_UNLIKELY((inverted - Q_UINT64_C(0x0101010101010101)) & ~inverted & Q_UINT64_C(0x8080808080808080))) {
+			crc = ff8Bytewise((const char *)p, 8, crc);
+		} else {
+			crc = t[7][p[0] ^ (crc >> 8)] ^ t[6][p[1] ^ (crc & 0xFF)]
+			    ^ t[5][p[2]] ^ t[4][p[3]] ^ t[3][p[4]] ^ t[2][p[5]]
+			    ^ t[1][p[6]] ^ t[0][p[7]];
+		}
+	}
+
+	return ff8Bytewise((const char *)p, size, crc);
+}
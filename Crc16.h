@@ -0,0 +1,48 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <QtCore>
+
+/*
+ * Checksum of FF8 saves: CRC-16/CCITT (polynomial 0x1021, most
+ * significant bit first), except that the table of the game has
+ * 255 entries, so the entry 0xFF is 0 instead of 0x1EF0.
+ * Because of that entry, the checksum is not linear.
+ */
+class Crc16
+{
+public:
+	// Without final xor, crc is the initial value
+	static quint16 ff8(const char *data, qint64 size, quint16 crc = 0xFFFF);
+	// One byte per iteration, reference implementation
+	static quint16 ff8Bytewise(const char *data, qint64 size, quint16 crc = 0xFFFF);
+private:
+	struct Tables {
+		Tables();
+		// t[k][b]: CRC-16 of the byte b followed by k null bytes
+		quint16 t[8][256];
+		// Byte k: index in the table at the k-th byte of a block,
+		// contribution of the CRC (hi and lo bytes) and of the j-th byte
+		quint64 indexHi[256], indexLo[256], index[8][256];
+	};
+	static const Tables &tables();
+};
+
+#endif // CRC16_H
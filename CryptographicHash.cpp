@@ -35,7 +35,6 @@ uint8_t CryptographicHash::psv_key[2][0x10] = {
 uint8_t CryptographicHash::psv_iv[0x10] = {0xB3, 0x0F, 0xFE, 0xED, 0xB7, 0xDC, 0x5E, 0xB7, 0x13, 0x3D, 0xA6, 0x0D, 0x1B, 0x6B, 0x2C, 0xDC};
 
 #define VMP_SEED_OFFSET 0xC
-#define VMP_HASH_OFFSET 0x20
 #define VMP_MCR_OFFSET 0x80
 #define PMV_MAGIC 0x564D5000
 #define VMP_SZ 0x20080
@@ -55,7 +54,16 @@ void CryptographicHash::xorWithByte(quint8 *buf, quint8 byte, quint8 length)
 
 QByteArray CryptographicHash::hashVmp(const QByteArray &data)
 {
-	QByteArray ret = data;
+	QList<QByteArray> segments;
+	segments.append(data);
+	hashVmp(segments);
+	return segments.first();
+}
+
+void CryptographicHash::hashVmp(QList<QByteArray> &segments)
+{
+	QByteArray &ret = segments.first();
+	Q_ASSERT(ret.size() >= VMP_HASH_OFFSET + VMP_HASH_SIZE);
 	struct AES_ctx aes_ctx;
 	AES_init_ctx_iv(&aes_ctx, vmp_key, vmp_iv);
 
@@ -85,8 +93,13 @@ QByteArray CryptographicHash::hashVmp(const QByteArray &data)
 
 	SHA1Update(&sha1_ctx_1, salt, 0x40);
 
-	memset(ret.data() + VMP_HASH_OFFSET, 0, 0x14);
-	SHA1Update(&sha1_ctx_1, (const unsigned char *)ret.constData(), VMP_SZ);
+	memset(ret.data() + VMP_HASH_OFFSET, 0, VMP_HASH_SIZE);
+	quint32 remaining = VMP_SZ;
+	for(const QByteArray &segment : qAsConst(segments)) {
+		const quint32 size = qMin(quint32(segment.size()), remaining);
+		SHA1Update(&sha1_ctx_1, (const unsigned char *)segment.constData(), size);
+		remaining -= size;
+	}
 
 	xorWithByte(salt, 0x6A, 0x40);
 
@@ -98,8 +111,6 @@ QByteArray CryptographicHash::hashVmp(const QByteArray &data)
 	SHA1Update(&sha1_ctx_2, work_buf, 0x14);
 
 	SHA1Final((unsigned char *)ret.data() + VMP_HASH_OFFSET, &sha1_ctx_2);
-
-	return ret;
 }
 
 QByteArray CryptographicHash::hashPsv(const QByteArray &data)
@@ -20,10 +20,16 @@
 
 #include <QtCore>
 
+#define VMP_HASH_OFFSET 0x20
+#define VMP_HASH_SIZE 0x14
+
 class CryptographicHash
 {
 public:
 	static QByteArray hashVmp(const QByteArray &data);
+	// The card is split in segments, the first one starts with the VMP header
+	// and receives the hash
+	static void hashVmp(QList<QByteArray> &segments);
 	static QByteArray hashPsv(const QByteArray &data);
 private:
 	static uint8_t vmp_key[0x10];
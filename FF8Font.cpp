@@ -0,0 +1,199 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "FF8Font.h"
+
+QImage *FF8Font::fontImage = 0;
+
+const quint8 FF8Font::charWidth[5][224] =
+{
+	{ // International
+		5, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 11, 7, 4, 5, 7,
+		10, 7, 7, 7, 9, 9, 6, 6, 5, 5, 4, 4, 4, 9, 7, 7,
+		4, 9, 7, 4, 9, 8, 8, 8, 8, 8, 8, 8, 8, 5, 7, 8,
+		7, 9, 8, 8, 8, 9, 8, 8, 9, 8, 9, 9, 9, 9, 9, 8,
+		7, 7, 7, 7, 5, 7, 7, 3, 5, 7, 3, 9, 7, 7, 7, 7,
+		6, 7, 6, 7, 7, 7, 7, 8, 7, 8, 8, 8, 8, 8, 8, 8,
+		8, 8, 5, 5, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8, 8, 9,
+		7, 8, 8, 8, 8, 7, 7, 7, 7, 7, 5, 5, 7, 7, 7, 7,
+		7, 7, 7, 7, 7, 7, 7, 9, 13, 5, 5, 9, 9, 9, 6, 6,
+		9, 11, 7, 7, 9, 4, 9, 9, 7, 11, 4, 7, 5, 5, 7, 13,
+		10, 10, 7, 9, 4, 7, 8, 7, 5, 9, 10, 10, 8, 8, 14, 8,
+		12, 8, 10, 8, 8, 8, 8, 8, 10, 8, 15, 8, 8, 8, 12, 8,
+		8, 12, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+	},{ // Jap - 0
+		11, 12, 11, 11, 11, 11, 12, 12, 12, 12, 11, 12, 11, 11, 11, 11,
+		11, 11, 11, 11, 12, 11, 11, 10, 11, 12, 11, 12, 11, 11, 11, 11,
+		12, 10, 11, 11, 11, 11, 11, 11, 11, 11, 12, 11, 11, 11, 11, 12,
+		12, 12, 12, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 7, 6, 8,
+		11, 11, 10, 11, 10, 11, 12, 12, 11, 11, 10, 11, 11, 11, 10, 10,
+		12, 11, 10, 10, 11, 10, 11, 10, 10, 11, 11, 11, 10, 11, 10, 11,
+		12, 11, 11, 11, 11, 11, 11, 11, 10, 10, 11, 11, 10, 11, 11, 11,
+		11, 11, 12, 11, 11, 11, 10, 11, 11, 11, 10, 11, 11, 10, 10, 12,
+		11, 11, 11, 11, 11, 10, 11, 10, 9, 9, 11, 10, 9, 11, 11, 10,
+		11, 10, 11, 11, 10, 10, 10, 10, 10, 10, 11, 10, 9, 9, 9, 10,
+		9, 9, 9, 8, 9, 9, 8, 9, 9, 7, 9, 9, 9, 9, 9, 9,
+		10, 9, 9, 9, 10, 10, 7, 8, 10, 9, 11, 9, 11, 9, 11, 9,
+		9, 10, 9, 9, 11, 9, 9, 9, 7, 10, 9, 9, 9, 9, 9, 11,
+		12, 10, 6, 6, 6, 6, 13, 13, 13, 13, 6, 4, 5, 4, 11, 10
+	},{ // Jap - 1
+		7, 13, 12, 13, 13, 13, 13, 13, 13, 12, 12, 13, 13, 13, 13, 13,
+		13, 13, 13, 13, 13, 13, 12, 12, 13, 12, 13, 13, 12, 13, 12, 13,
+		13, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 12, 13, 12, 12,
+		13, 13, 13, 12, 13, 12, 13, 13, 13, 13, 13, 12, 12, 13, 13, 13,
+		11, 12, 11, 13, 13, 12, 13, 13, 12, 13, 13, 13, 11, 13, 13, 13,
+		11, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13, 13,
+		13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 11, 13,
+		13, 13, 13, 13, 13, 13, 13, 12, 12, 13, 13, 13, 13, 13, 13, 13,
+		13, 12, 13, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 13, 12,
+		12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 11, 12,
+		12, 12, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 12,
+		13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13,
+		12, 12, 13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13,
+		13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 12, 13, 13, 13
+	},{ // Jap - 2
+		13, 13, 12, 12, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13, 12,
+		13, 13, 13, 12, 13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12,
+		13, 13, 12, 13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 12, 12, 13,
+		13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 12, 13, 13, 13, 11,
+		13, 13, 13, 12, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 13,
+		12, 13, 13, 13, 13, 12, 13, 13, 13, 9, 13, 13, 13, 13, 12, 13,
+		13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13, 12, 13,
+		13, 13, 12, 13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13,
+		13, 13, 12, 12, 13, 13, 13, 13, 13, 13, 13, 12, 13, 12, 12, 13,
+		13, 13, 13, 13, 12, 12, 13, 13, 13, 13, 13, 13, 12, 13, 13, 13,
+		12, 13, 13, 13, 13, 13, 12, 13, 12, 13, 13, 13, 13, 13, 13, 13,
+		12, 13, 13, 13, 12, 12, 13, 13, 12, 13, 13, 13, 13, 13, 13, 13,
+		13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13, 13, 13,
+		14, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13
+	},{ // Jap - 3
+		13, 13, 13, 11, 13, 13, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13,
+		13, 13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 14, 13, 13, 13,
+		13, 11, 12, 13, 12, 13, 13, 13, 13, 12, 12, 13, 12, 13, 13, 13,
+		13, 12, 13, 13, 13, 13, 13, 13, 12, 12, 13, 13, 13, 13, 12, 13,
+		13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13,
+		13, 13, 13, 13, 13, 13, 11, 13, 13, 13, 13, 13, 13, 12, 12, 13,
+		13, 13, 12, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 12,
+		13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13, 13, 13, 13, 13, 13,
+		13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12,
+		13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13, 13, 13,
+		12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13, 12, 13, 13,
+		13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 13,
+		13, 12, 13, 13, 13, 13, 13, 13, 13, 13, 12, 13, 12, 13, 13, 13,
+		9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+	}
+};
+
+void FF8Font::reload()
+{
+	if(fontImage) {
+		delete fontImage;
+	}
+	fontImage = new QImage(QString(":/images/font%1.png").arg(Config::value(Config::Font)));
+}
+
+void FF8Font::drawTextArea(QPainter *painter, const QPoint &point, const QString &text, int forceLang)
+{
+	bool jp = forceLang==2 || (forceLang==0 && QObject::tr("false", "Use Japanese Encoding")=="true");
+	QByteArray ff8Text = FF8Text::toByteArray(text, jp);
+	if(ff8Text.isEmpty())	return;
+
+	/* Text */
+
+	int x = point.x(), y = point.y(), size = ff8Text.size();
+
+	for(int i=0 ; i<size ; ++i)
+	{
+		quint8 charId = (quint8)ff8Text.at(i);
+
+		if(charId>=32)
+		{
+			if(jp) {
+				letter(&x, &y, charId-32, painter, 1);// 210-32
+			} else {
+				if(charId<227) {
+					letter(&x, &y, charId-32, painter);
+				} else if(charId>=232) {
+					letter(&x, &y, optimisedDuo[charId-232][0], painter);
+					letter(&x, &y, optimisedDuo[charId-232][1], painter);
+				}
+			}
+		}
+		else if(charId<=2)//NewPage \n
+			break;
+		else if(charId<32)
+		{
+			++i;
+			if(jp) {
+				switch(charId)
+				{
+				case 0x19: // Jap 1
+					letter(&x, &y, (quint8)ff8Text.at(i)-0x20, painter, 2);
+					break;
+				case 0x1a: // Jap 2
+					letter(&x, &y, (quint8)ff8Text.at(i)-0x20, painter, 3);
+					break;
+				case 0x1b: // Jap 3
+					letter(&x, &y, (quint8)ff8Text.at(i)-0x20, painter, 4);
+					break;
+				}
+			}
+		}
+	}
+}
+
+void FF8Font::letter(int *x, int *y, int charId, QPainter *painter, quint8 tableId)
+{
+	int charIdImage = charId + 231*tableId;
+	int charSrcWidth = Config::value(Config::Font).isEmpty() ? 12 : 24;
+
+	if(!fontImage)
+		reload();
+
+	painter->drawImage(QRect(*x, *y, 24, 24), fontImage->copy((charIdImage%21)*charSrcWidth, (charIdImage/21)*charSrcWidth, charSrcWidth, charSrcWidth));
+	*x += charWidth[tableId][charId]*2;
+}
+
+const char *FF8Font::optimisedDuo[24] =
+{
+	"\x47\x4c",//in
+	"\x43\x00",//e
+	"\x4c\x43",//ne
+	"\x52\x4d",//to
+	"\x50\x43",//re
+	"\x2c\x34",//HP
+	"\x4a\x00",//l
+	"\x4a\x4a",//ll
+	"\x2b\x2a",//GF
+	"\x4c\x52",//nt
+	"\x47\x4a",//il
+	"\x4d\x00",//o
+	"\x43\x44",//ef
+	"\x4d\x4c",//on
+	"\x00\x55",// w
+	"\x00\x50",// r
+	"\x55\x47",//wi
+	"\x44\x47",//fi
+	"\x29\x27",//EC
+	"\x51\x00",//s
+	"\x3f\x50",//ar
+	"\x2a\x29",//FE
+	"\x00\x37",// S
+	"\x3f\x45" //ag
+};
@@ -0,0 +1,36 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef DEF_FF8FONT
+#define DEF_FF8FONT
+
+#include <QtGui>
+#include "FF8Text.h"
+
+class FF8Font
+{
+public:
+	static void reload();
+	static void drawTextArea(QPainter *painter, const QPoint &point, const QString &ff8Text, int forceLang=0);// 1: latin 2: japanese
+private:
+	static QImage *fontImage;
+	static void letter(int *x, int *y, int charId, QPainter *painter, quint8 tableId=0);
+	static const char *optimisedDuo[24];
+	static const quint8 charWidth[5][224];
+};
+
+#endif
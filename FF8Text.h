@@ -20,7 +20,6 @@
 #define DEF_FF8TEXT
 
 #include <QtCore>
-#include <QPainter>
 #include "Data.h"
 #include "Config.h"
 
@@ -31,14 +30,9 @@ public:
 	static QByteArray toByteArray(const QString &string, bool jp=false);
 	static QString caract(quint8 ord, quint8 table=0);
 
-	static void reloadFont();
-	static void drawTextArea(QPainter *painter, const QPoint &point, const QString &ff8Text, int forceLang=0);// 1: latin 2: japanese
 	static QByteArray numToBiosText(quint32 num, quint8 width=0);
+	static void numToBiosText(quint32 num, quint8 width, char *out);
 private:
-	static QImage *fontImage;
-	static void letter(int *x, int *y, int charId, QPainter *painter, quint8 tableId=0);
-	static const char *optimisedDuo[24];
-	static const quint8 charWidth[5][224];
 	static const char *_caract[240];
 	static const char *_caractJp[240];
 	static const char *_caractJp19[240];
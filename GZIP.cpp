@@ -16,54 +16,110 @@
  ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
  ****************************************************************************/
 #include "GZIP.h"
+#include <QtConcurrent>
 #include <zlib.h>
+#include <climits>
 #undef compress // conflict with GZIP::compress
 
 #define BUF_SIZE	8192
+#define BLOCK_SIZE	1048576
 
-QByteArray GZIP::decompress(const QByteArray &data, int/* decSize*/)
+QByteArray GZIP::decompress(const QByteArray &data, int decSize)
 {
 	QByteArray ungzip;
+	z_stream stream;
+	int ret, size = 0;
+	bool hasMember = false;
 
-	QTemporaryFile temp;
-	if(!temp.open()) {
-		return QByteArray();
+	// Not compressed: returned as is, like gzread does
+	if(!data.startsWith("\x1f\x8b")) {
+		return data;
 	}
-	temp.write(data);
-	temp.close();
-	gzFile file = gzopen(temp.fileName().toLatin1(), "rb");
-	if(!file) {
+
+	memset(&stream, 0, sizeof(stream));
+
+	if(inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) { // gzip format
 		return QByteArray();
 	}
-	char buffer[BUF_SIZE];
-	int r;
-	while((r = gzread(file, buffer, BUF_SIZE)) > 0) {
-		ungzip.append(buffer, r);
+
+	stream.next_in = (Bytef *)data.constData();
+	stream.avail_in = uInt(data.size());
+
+	try {
+		ungzip.resize(decSize > 0 ? decSize : int(qBound(qint64(BUF_SIZE), qint64(data.size()) * 4, qint64(INT_MAX / 2))));
+
+		forever {
+			if(size >= ungzip.size()) {
+				// The doubled size would not fit in an int
+				if(ungzip.size() > INT_MAX / 2) {
+					inflateEnd(&stream);
+					return QByteArray();
+				}
+				ungzip.resize(ungzip.size() * 2);
+			}
+
+			stream.next_out = (Bytef *)ungzip.data() + size;
+			stream.avail_out = uInt(ungzip.size() - size);
+
+			ret = inflate(&stream, Z_NO_FLUSH);
+			size = ungzip.size() - int(stream.avail_out);
+
+			if(ret == Z_STREAM_END) {
+				if(stream.avail_in == 0) {
+					break;
+				}
+				// Concatenated gzip member
+				hasMember = true;
+				inflateReset(&stream);
+			} else if(ret == Z_BUF_ERROR && stream.avail_out > 0) {
+				break; // Truncated data
+			} else if(ret != Z_OK && ret != Z_BUF_ERROR) {
+				if(!hasMember) {
+					inflateEnd(&stream);
+					return QByteArray();
+				}
+				break; // Garbage after a gzip member is ignored, like gzread does
+			}
+		}
+	} catch(const std::bad_alloc &) {
+		inflateEnd(&stream);
+		return QByteArray();
 	}
-	gzclose(file);
+
+	inflateEnd(&stream);
+	ungzip.truncate(size);
 
 	return ungzip;
 }
 
-QByteArray GZIP::compress(const QByteArray &ungzip)
+QByteArray GZIP::compress(const QByteArray &ungzip, int level)
 {
-	QString tempPath = QDir::tempPath()+"/qt_temp.gz";
+	QByteArray gzip;
+	z_stream stream;
+
+	memset(&stream, 0, sizeof(stream));
 
-	gzFile file2 = gzopen(tempPath.toLatin1(), "wb9");
-	if(!file2) {
+	if(deflateInit2(&stream, level, Z_DEFLATED,
+	                16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) { // gzip format
 		return QByteArray();
 	}
-	gzwrite(file2, ungzip.constData(), ungzip.size());
-	gzclose(file2);
-	QFile finalFile(tempPath);
-	if(!finalFile.open(QIODevice::ReadOnly)) {
+
+	gzip.resize(int(deflateBound(&stream, uLong(ungzip.size()))));
+
+	stream.next_in = (Bytef *)ungzip.constData();
+	stream.avail_in = uInt(ungzip.size());
+	stream.next_out = (Bytef *)gzip.data();
+	stream.avail_out = uInt(gzip.size());
+
+	if(deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+		deflateEnd(&stream);
 		return QByteArray();
 	}
 
-	QByteArray data = finalFile.readAll();
-	finalFile.remove();
+	gzip.truncate(int(stream.total_out));
+	deflateEnd(&stream);
 
-	return data;
+	return gzip;
 }
 
 bool GZIP::decompress(const QString &pathFrom, const QString &pathTo)
@@ -88,24 +144,67 @@ bool GZIP::decompress(const QString &pathFrom, const QString &pathTo)
 	return true;
 }
 
-bool GZIP::compress(const QString &pathFrom, const QString &pathTo)
+struct GZIPBlockCompressor
+{
+	typedef QByteArray result_type;
+
+	explicit GZIPBlockCompressor(int level) : level(level) {}
+
+	QByteArray operator()(const QByteArray &block) const {
+		return GZIP::compress(block, level);
+	}
+
+	int level;
+};
+
+bool GZIP::compress(const QString &pathFrom, const QString &pathTo, int level)
 {
 	QFile from(pathFrom);
 	if(!from.open(QIODevice::ReadOnly)) {
 		return false;
 	}
 
-	gzFile file = gzopen(pathTo.toLatin1(), "wb9");
-	if(!file) {
+	QFile to(pathTo);
+	if(!to.open(QIODevice::WriteOnly)) {
 		return false;
 	}
-	char buffer[BUF_SIZE];
-	int r;
-	while((r = from.read(buffer, BUF_SIZE)) > 0) {
-		gzwrite(file, buffer, BUF_SIZE);
+
+	// Blocks are compressed in parallel as independent gzip members,
+	// a gzip file can be a concatenation of members
+	const int batchSize = qMax(1, QThread::idealThreadCount()) * 2;
+	bool empty = true;
+
+	forever {
+		QList<QByteArray> blocks;
+
+		while(blocks.size() < batchSize) {
+			QByteArray block = from.read(BLOCK_SIZE);
+			if(block.isEmpty()) {
+				break;
+			}
+			blocks.append(block);
+		}
+
+		if(blocks.isEmpty()) {
+			if(!empty) {
+				break;
+			}
+			blocks.append(QByteArray()); // Empty gzip member
+		}
+		empty = false;
+
+		QList<QByteArray> members = QtConcurrent::blockingMapped<QList<QByteArray> >(blocks, GZIPBlockCompressor(level));
+
+		for(const QByteArray &member : qAsConst(members)) {
+			if(member.isEmpty() || to.write(member) != member.size()) {
+				return false;
+			}
+		}
+
+		if(blocks.size() < batchSize) {
+			break;
+		}
 	}
-	gzclose(file);
-	from.close();
 
-	return true;
+	return from.error() == QFile::NoError;
 }
@@ -24,9 +24,10 @@ class GZIP
 {
 public:
 	static QByteArray decompress(const QByteArray &data, int decSize);
-	static QByteArray compress(const QByteArray &ungzip);
+	static QByteArray compress(const QByteArray &ungzip, int level = 9);
 	static bool decompress(const QString &pathFrom, const QString &pathTo);
-	static bool compress(const QString &pathFrom, const QString &pathTo);
+	// Compress in 1 MB blocks on several threads
+	static bool compress(const QString &pathFrom, const QString &pathTo, int level = 9);
 };
 
 #endif // GZIP_H
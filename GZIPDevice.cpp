@@ -0,0 +1,164 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#include "GZIPDevice.h"
+#include <zlib.h>
+
+GZIPDevice::GZIPDevice(QIODevice *device) :
+	_device(device), _stream(nullptr),
+	_transparent(false), _hasMember(false), _end(false), _pos(0)
+{
+}
+
+GZIPDevice::~GZIPDevice()
+{
+	close();
+}
+
+bool GZIPDevice::open(OpenMode mode)
+{
+	if(mode & WriteOnly) {
+		setErrorString(QObject::tr("Mode d'ouverture non supporté"));
+		return false;
+	}
+
+	if(!_device->isOpen() && !_device->open(mode)) {
+		setErrorString(_device->errorString());
+		return false;
+	}
+
+	_transparent = !_device->peek(2).startsWith("\x1f\x8b");
+	_hasMember = _end = false;
+	_pos = 0;
+
+	if(!_transparent) {
+		z_stream *stream = new z_stream;
+		memset(stream, 0, sizeof(z_stream));
+		_stream = stream;
+
+		if(inflateInit2(stream, 16 + MAX_WBITS) != Z_OK) { // gzip format
+			delete stream;
+			_stream = nullptr;
+			setErrorString(QObject::tr("Impossible de décompresser le fichier."));
+			return false;
+		}
+	}
+
+	return QIODevice::open(mode | Unbuffered);
+}
+
+void GZIPDevice::close()
+{
+	if(_stream) {
+		z_stream *stream = (z_stream *)_stream;
+		inflateEnd(stream);
+		delete stream;
+		_stream = nullptr;
+	}
+
+	QIODevice::close();
+}
+
+bool GZIPDevice::isSequential() const
+{
+	return true;
+}
+
+bool GZIPDevice::atEnd() const
+{
+	return _transparent ? _device->atEnd() : _end;
+}
+
+bool GZIPDevice::skipTo(qint64 pos)
+{
+	char buffer[8192];
+
+	while(_pos < pos) {
+		if(read(buffer, qMin(pos - _pos, qint64(sizeof(buffer)))) <= 0) {
+			return false;
+		}
+	}
+
+	return _pos == pos;
+}
+
+qint64 GZIPDevice::readData(char *data, qint64 maxSize)
+{
+	if(_transparent) {
+		qint64 r = _device->read(data, maxSize);
+		if(r > 0) {
+			_pos += r;
+		}
+		return r;
+	}
+
+	if(_end || !_stream) {
+		return 0;
+	}
+
+	z_stream *stream = (z_stream *)_stream;
+
+	stream->next_out = (Bytef *)data;
+	stream->avail_out = uInt(qMin(maxSize, qint64(0x7FFFFFFF)));
+	const uInt size = stream->avail_out;
+
+	while(stream->avail_out > 0) {
+		if(stream->avail_in == 0) {
+			qint64 r = _device->read(_in, sizeof(_in));
+			if(r <= 0) {
+				_end = true; // Truncated data
+				break;
+			}
+			stream->next_in = (Bytef *)_in;
+			stream->avail_in = uInt(r);
+		}
+
+		int ret = inflate(stream, Z_NO_FLUSH);
+
+		if(ret == Z_STREAM_END) {
+			_hasMember = true;
+			if(stream->avail_in == 0 && _device->atEnd()) {
+				_end = true;
+				break;
+			}
+			// Concatenated gzip member
+			inflateReset(stream);
+		} else if(ret != Z_OK && ret != Z_BUF_ERROR) {
+			_end = true;
+			if(!_hasMember) {
+				setErrorString(QObject::tr("Impossible de décompresser le fichier."));
+				if(size == stream->avail_out) {
+					return -1;
+				}
+			}
+			break; // Garbage after a gzip member is ignored, like gzread does
+		}
+	}
+
+	qint64 read = size - stream->avail_out;
+	_pos += read;
+
+	return read;
+}
+
+qint64 GZIPDevice::writeData(const char *data, qint64 maxSize)
+{
+	Q_UNUSED(data)
+	Q_UNUSED(maxSize)
+
+	return -1;
+}
@@ -0,0 +1,52 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef GZIPDEVICE_H
+#define GZIPDEVICE_H
+
+#include <QtCore>
+
+// Read-only sequential device that inflates a gzip stream from device
+// as it is read: nothing after the last byte read is decompressed.
+// Like gzread, data which is not gzip is read as is.
+class GZIPDevice : public QIODevice
+{
+public:
+	explicit GZIPDevice(QIODevice *device);
+	virtual ~GZIPDevice();
+	virtual bool open(OpenMode mode);
+	virtual void close();
+	virtual bool isSequential() const;
+	virtual bool atEnd() const;
+	// Decompress and drop data up to the position pos
+	bool skipTo(qint64 pos);
+	// Position in the decompressed data
+	inline qint64 position() const {
+		return _pos;
+	}
+protected:
+	virtual qint64 readData(char *data, qint64 maxSize);
+	virtual qint64 writeData(const char *data, qint64 maxSize);
+private:
+	QIODevice *_device;
+	void *_stream;// z_stream
+	char _in[8192];
+	bool _transparent, _hasMember, _end;
+	qint64 _pos;
+};
+
+#endif // GZIPDEVICE_H
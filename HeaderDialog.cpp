@@ -18,6 +18,7 @@
 
 #include "HeaderDialog.h"
 #include "Config.h"
+#include "SaveIcon.h"
 
 HeaderDialog::HeaderDialog(SaveData *saveData, QWidget *parent, ViewType viewType)
 	: QDialog(parent, Qt::Dialog | Qt::WindowCloseButtonHint), saveData(saveData), viewType(viewType)
@@ -97,7 +98,7 @@ HeaderDialog::HeaderDialog(SaveData *saveData, QWidget *parent, ViewType viewTyp
 	icon1 = new QComboBox();
 	icon1->setIconSize(QSize(16, 16));
 	for(const SaveIconData &saveIcon : qAsConst(saveIcons)) {
-		icon1->addItem(QIcon(saveIcon.icon()), QString(), saveIcon.data().left(160));
+		icon1->addItem(QIcon(SaveIcon::icon(saveIcon)), QString(), saveIcon.data().left(160));
 	}
 	QPushButton *icon1_saveButton = new QPushButton();
 	QIcon saveIcon(QApplication::style()->standardIcon(QStyle::SP_DialogSaveButton));
@@ -108,7 +109,7 @@ HeaderDialog::HeaderDialog(SaveData *saveData, QWidget *parent, ViewType viewTyp
 	icon2 = new QComboBox();
 	icon2->setIconSize(QSize(32, 32));
 	for(const SaveIconData &saveIcon : qAsConst(saveIcons)) {
-		icon2->addItem(QIcon(saveIcon.icon(0, true)), QString(), saveIcon.data().mid(160));
+		icon2->addItem(QIcon(SaveIcon::icon(saveIcon, 0, true)), QString(), saveIcon.data().mid(160));
 	}
 	icon2_saveButton = new QPushButton();
 	icon2_saveButton->setIcon(saveIcon);
@@ -167,7 +168,7 @@ void HeaderDialog::fillId(QComboBox *id, int saveId)
 
 void HeaderDialog::fill()
 {
-	setWindowIcon(QIcon(saveData->saveIcon().icon()));
+	setWindowIcon(QIcon(SaveIcon::icon(saveData->saveIcon())));
 
 	if(viewType == NormalView && !saveData->hasMCHeader()) {
 		group1->hide();
@@ -210,7 +211,7 @@ void HeaderDialog::fill()
 		desc_auto->setChecked(saveData->isDescriptionAuto());
 		desc_auto->setVisible(saveData->isFF8());
 		bloc->setText(QString::number(saveData->blockCount()));
-		QImage pix = saveData->saveIcon().icon().toImage();
+		QImage pix = SaveIcon::icon(saveData->saveIcon()).toImage();
 		int currentIndex = -1;
 		for(int i=0 ; i<icon1->count() ; ++i) {
 			if(icon1->itemIcon(i).pixmap(16).toImage() == pix) {
@@ -224,7 +225,7 @@ void HeaderDialog::fill()
 		}
 		icon1->setCurrentIndex(currentIndex);
 		if(saveData->isFF8()) {
-			pix = saveData->saveIcon().icon(0, true).toImage();
+			pix = SaveIcon::icon(saveData->saveIcon(), 0, true).toImage();
 			currentIndex = -1;
 			for(int i=0 ; i<icon2->count() ; ++i) {
 				if(icon2->itemIcon(i).pixmap(32).toImage() == pix) {
@@ -342,7 +343,7 @@ void HeaderDialog::saveIcon(bool chocobo_world_icon)
 	int index = path.lastIndexOf('/');
 	Config::setValue(Config::SavePathIcon, index == -1 ? path : path.left(index));
 
-	if(!saveData->saveIcon().icon(0, chocobo_world_icon).save(path)) {
+	if(!SaveIcon::icon(saveData->saveIcon(), 0, chocobo_world_icon).save(path)) {
 		QMessageBox::warning(this, tr("Erreur"), tr("Format incorrect."));
 	}
 }
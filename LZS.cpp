@@ -26,133 +26,141 @@
 
 #include "LZS.h"
 
-qint32 LZS::match_length=0;//of longest match. These are set by the InsertNode() procedure.
-qint32 LZS::match_position=0;
-qint32 LZS::lson[4097];//left & right children & parents -- These constitute binary search trees.
-qint32 LZS::rson[4353];
-qint32 LZS::dad[4097];
-unsigned char LZS::text_buf[4113];//ring buffer of size 4096, with extra 17 bytes to facilitate string comparison
-QByteArray LZS::result;
-
-const QByteArray &LZS::decompress(const QByteArray &data, int max)
+LZS::LZS() :
+	match_length(0), match_position(0)
 {
-	int curResult=0, fileSize=data.size(), sizeAlloc=max+10;
-	quint16 curBuff=4078, adresse, premOctet=0, i, length;
-	const quint8 *fileData = (const quint8 *)data.constData();
-	const quint8 *endFileData = fileData + fileSize;
-
-	// Impossible case
-	if(quint64(sizeAlloc) > 2000 * quint64(fileSize)) {
-		qWarning() << "LZS::decompress impossible ratio case" << sizeAlloc << 2000 * quint64(fileSize);
-		result.clear();
-		return result;
-	}
+}
 
-	if(result.size() < sizeAlloc) {
-		try {
-			result.resize(sizeAlloc);
-		} catch(std::bad_alloc) {
-			result.clear();
-			return result;
-		}
-	}
+/* The output is used as the window: the ring buffer position of the output
+ * byte n is (4078 + n) & 4095, so a reference to the ring buffer address is
+ * a reference to the output at a distance of 1 to 4096 bytes. Addresses
+ * before the start of the output are the zeros of the initial ring buffer.
+ * Every read is checked against the end of the input, a truncated reference
+ * ends the decompression. */
 
-	memset(text_buf, 0, 4078);//Le buffer de 4096 octets est initialisé à 0
+int LZS::decompress(const char *data, int size, char *out, int max)
+{
+	const quint8 *fileData = (const quint8 *)data;
+	const quint8 *endFileData = fileData + size;
+	quint8 *result = (quint8 *)out;
+	int curResult = 0;
+	quint16 premOctet = 0;
 
-	forever
+	while(curResult < max)
 	{
 		if(((premOctet >>= 1) & 256) == 0) {
-			premOctet = *fileData++ | 0xff00;//On récupère le premier octet puis on avance d'un octet
-		}
-
-		if(fileData >= endFileData || curResult >= max) {
-			result.truncate(curResult);
-			return result;//Fini !
+			if(fileData >= endFileData) {
+				break;
+			}
+			premOctet = *fileData++ | 0xff00;
+
+			// 8 literals
+			if(premOctet == 0xffff && endFileData - fileData >= 8 && max - curResult >= 8) {
+				memcpy(result + curResult, fileData, 8);
+				fileData += 8;
+				curResult += 8;
+				premOctet = 0;
+				continue;
+			}
 		}
 
 		if(premOctet & 1)
 		{
-			result[curResult] = text_buf[curBuff] = *fileData++;//On récupère l'octet (qui n'est pas compressé) et on le sauvegarde dans la chaine finale (result) et dans le buffer. Et bien sûr on fait avancer les curseurs d'un octet.
-			curBuff = (curBuff + 1) & 4095;//Le curseur du buffer doit toujours être entre 0 et 4095
-			++curResult;
+			if(fileData >= endFileData) {
+				break;
+			}
+			result[curResult++] = *fileData++;
 		}
 		else
 		{
-//			quint16 twoBytes = *((const quint16 *)fileData);
-//			adresse = (twoBytes & 0x00FF) | ((twoBytes & 0xF000) >> 4);
-//			length = ((twoBytes & 0x0F00) >> 8) + 2 + adresse;
-//			fileData += 2;
+			if(endFileData - fileData < 2) {
+				break; // Truncated reference
+			}
 
-			adresse = *fileData++;
-			length = *fileData++;
-			adresse |= (length & 0xF0) << 4;//on récupère l'adresse dans les deux octets (qui sont "compressés")
-			length = (length & 0xF) + 2 + adresse;
+			const int adresse = fileData[0] | ((fileData[1] & 0xF0) << 4);
+			int length = (fileData[1] & 0xF) + 3;
+			fileData += 2;
 
-			for(i=adresse ; i<=length ; ++i)
-			{
-				result[curResult] = text_buf[curBuff] = text_buf[i & 4095];//On va chercher l'octet (qui est décompressé) dans le buffer à l'adresse indiquée puis on le sauvegarde dans la chaine finale et le buffer.
-				curBuff = (curBuff + 1) & 4095;
-				++curResult;
+			int distance = ((4078 + curResult) - adresse) & 4095;
+			if(distance == 0) {
+				distance = 4096;
+			}
+			const int src = curResult - distance;
+
+			if(length > max - curResult) {
+				length = max - curResult;
 			}
+
+			if(src >= 0 && distance >= 8 && curResult + 24 <= max) {
+				// At most 18 bytes: three 8-byte copies, each one only reads bytes already written
+				memcpy(result + curResult, result + src, 8);
+				memcpy(result + curResult + 8, result + src + 8, 8);
+				memcpy(result + curResult + 16, result + src + 16, 8);
+			} else if(src >= 0 && distance >= length) {
+				memcpy(result + curResult, result + src, length);
+			} else if(src >= 0 && distance == 1) { // Run of one byte
+				memset(result + curResult, result[src], length);
+			} else if(src + length <= 0) { // Initial ring buffer
+				memset(result + curResult, 0, length);
+			} else {
+				for(int i=0 ; i<length ; ++i) {
+					result[curResult + i] = src + i >= 0 ? result[src + i] : 0;
+				}
+			}
+
+			curResult += length;
 		}
 	}
+
+	return curResult;
 }
 
-const QByteArray &LZS::decompressAll(const QByteArray &data)
+bool LZS::decompress(const QByteArray &data, QByteArray &out, int max)
 {
-	int curResult=0, fileSize=data.size(), sizeAlloc=fileSize*5;
-	quint16 curBuff=4078, adresse, premOctet=0, i, length;
-	const quint8 *fileData = (const quint8 *)data.constData();
-	const quint8 *endFileData = fileData + fileSize;
+	// Impossible case
+	if(quint64(max) > 2000 * quint64(data.size())) {
+		qWarning() << "LZS::decompress impossible ratio case" << max << 2000 * quint64(data.size());
+		out.clear();
+		return false;
+	}
 
-	if(result.size() < sizeAlloc) {
-		try {
-			result.resize(sizeAlloc);
-		} catch(std::bad_alloc) {
-			result.clear();
-			return result;
-		}
+	try {
+		out.resize(max);
+	} catch(const std::bad_alloc &) {
+		out.clear();
+		return false;
 	}
 
-	memset(text_buf, 0, 4078);//Le buffer de 4096 octets est initialisé à 0
+	out.truncate(decompress(data.constData(), data.size(), out.data(), max));
 
-	forever
-	{
-		if(((premOctet >>= 1) & 256) == 0) {
-			premOctet = *fileData++ | 0xff00;//On récupère le premier octet puis on avance d'un octet
-		}
+	return true;
+}
 
-		if(fileData >= endFileData) {
-			result.truncate(curResult);
-			return result;//Fini !
-		}
+bool LZS::decompressAll(const QByteArray &data, QByteArray &out)
+{
+	// 8 references of 18 bytes for 17 bytes of input in the worst case
+	qint64 max = qint64(data.size() / 17 + 1) * 144;
 
-		if(premOctet & 1)
-		{
-			result[curResult] = text_buf[curBuff] = *fileData++;//On récupère l'octet (qui n'est pas compressé) et on le sauvegarde dans la chaine finale (result) et dans le buffer. Et bien sûr on fait avancer les curseurs d'un octet.
-			curBuff = (curBuff + 1) & 4095;//Le curseur du buffer doit toujours être entre 0 et 4095
-			++curResult;
-		}
-		else
-		{
-//			quint16 twoBytes = *((const quint16 *)fileData);
-//			adresse = (twoBytes & 0x00FF) | ((twoBytes & 0xF000) >> 4);
-//			length = ((twoBytes & 0x0F00) >> 8) + 2 + adresse;
-//			fileData += 2;
+	if(max > 0x7FFFFFFF) {
+		out.clear();
+		return false;
+	}
 
-			adresse = *fileData++;
-			length = *fileData++;
-			adresse |= (length & 0xF0) << 4;//on récupère l'adresse dans les deux octets (qui sont "compressés")
-			length = (length & 0xF) + 2 + adresse;
+	return decompress(data, out, int(max));
+}
 
-			for(i=adresse ; i<=length ; ++i)
-			{
-				result[curResult] = text_buf[curBuff] = text_buf[i & 4095];//On va chercher l'octet (qui est décompressé) dans le buffer à l'adresse indiquée puis on le sauvegarde dans la chaine finale et le buffer.
-				curBuff = (curBuff + 1) & 4095;
-				++curResult;
-			}
-		}
-	}
+QByteArray LZS::decompress(const QByteArray &data, int max)
+{
+	QByteArray result;
+	decompress(data, result, max);
+	return result;
+}
+
+QByteArray LZS::decompressAll(const QByteArray &data)
+{
+	QByteArray result;
+	decompressAll(data, result);
+	return result;
 }
 
 void LZS::InsertNode(qint32 r)
@@ -275,18 +283,37 @@ void LZS::DeleteNode(qint32 p)//deletes node p from tree
 	dad[p] = 4096;
 }
 
-const QByteArray &LZS::compress(const QByteArray &fileData)
+int LZS::compressBound(int size)
 {
-	int i, c, len, r, s, code_buf_ptr,
-			curResult = 0, sizeData = fileData.size(), sizeAlloc = sizeData / 2;
-	unsigned char code_buf[17], mask;
-	const char *fileConstData = fileData.constData();
-	const char *fileConstDataEnd = &fileConstData[sizeData-1] + 1;
+	// One flag byte every 8 literals in the worst case
+	return size + (size + 7) / 8;
+}
 
-	if(result.size() < sizeAlloc) {
-		result.resize(sizeAlloc);
+int LZS::compress(const char *data, int size, char *out, Level level)
+{
+	switch(level) {
+	case Tree:
+		return compressTree(data, size, out);
+	case Fast:
+		return compressHashChain(data, size, out, 4, false);
+	case Default:
+		return compressHashChain(data, size, out, 128, true);
+	case Best:
+		return compressHashChain(data, size, out, 4096, true);
+	case Optimal:
+		return compressOptimal(data, size, out);
 	}
 
+	return compressTree(data, size, out);
+}
+
+int LZS::compressTree(const char *data, int size, char *out)
+{
+	int i, c, len, r, s, code_buf_ptr, curResult = 0;
+	unsigned char code_buf[17], mask;
+	const char *fileConstData = data;
+	const char *fileConstDataEnd = data + size;
+
 	/* quint32
 		textsize = 0,//text size counter
 		codesize = 0;//code size counter */
@@ -314,8 +341,7 @@ const QByteArray &LZS::compress(const QByteArray &fileData)
 		text_buf[r + len] = *fileConstData++;//Read 18 bytes into the last 18 bytes of the buffer
 	}
 	if(/* (textsize =  */len/* ) */ == 0) {
-		result.clear();
-		return result;//text of size zero
+		return 0;//text of size zero
 	}
 
 	for(i=1 ; i<=18 ; ++i)
@@ -344,7 +370,7 @@ const QByteArray &LZS::compress(const QByteArray &fileData)
 		{
 //			for(i=0 ; i<code_buf_ptr ; ++i)//Send at most 8 units of
 //				result.append(code_buf[i]);//code together
-			result.replace(curResult, code_buf_ptr, (char *)code_buf, code_buf_ptr);
+			memcpy(out + curResult, code_buf, code_buf_ptr);
 			curResult += code_buf_ptr;
 			code_buf[0] = 0;
 			code_buf_ptr = mask = 1;
@@ -382,14 +408,496 @@ const QByteArray &LZS::compress(const QByteArray &fileData)
 	{
 //		for(i = 0; i < code_buf_ptr ; ++i)
 //			result.append(code_buf[i]);
-		result.replace(curResult, code_buf_ptr, (char *)code_buf, code_buf_ptr);
+		memcpy(out + curResult, code_buf, code_buf_ptr);
 		curResult += code_buf_ptr;
 	}
-	result.truncate(curResult);
-	return result;
+	return curResult;
+}
+
+/* Hash chains match finder
+ * Positions are relative to the start of the data. Like the tree encoder, the
+ * 18 positions before the data are matchable: the ring buffer is initialized
+ * with zeros, so these bytes are implicit zeros.
+ * The window is limited to 4078 bytes (4096 - 18), as the tree encoder does,
+ * to produce references that any decoder of this format accepts. */
+
+#define LZS_WINDOW		4078
+#define LZS_MIN_MATCH	3
+#define LZS_MAX_MATCH	18
+#define LZS_NIL			qint32(-0x7FFFFFFF)
+
+static inline quint8 lzsByte(const quint8 *data, qint32 pos)
+{
+	return pos < 0 ? 0 : data[pos];
+}
+
+static inline quint32 lzsHash(const quint8 *data, qint32 pos)
+{
+	quint32 key = (lzsByte(data, pos) << 16) | (lzsByte(data, pos + 1) << 8) | lzsByte(data, pos + 2);
+	return (key * 2654435761U) >> 20;
+}
+
+inline void LZS::insertHash(const quint8 *data, qint32 pos)
+{
+	quint32 h = lzsHash(data, pos);
+	prev[pos & 4095] = head[h];
+	head[h] = pos;
+}
+
+void LZS::findMatch(const quint8 *data, int size, qint32 pos, int maxChain)
+{
+	const int maxLen = qMin(LZS_MAX_MATCH, size - pos);
+
+	match_length = 0;
+
+	if(maxLen < LZS_MIN_MATCH) {
+		return;
+	}
+
+	qint32 cand = head[lzsHash(data, pos)];
+
+	while(cand != LZS_NIL && pos - cand <= LZS_WINDOW && maxChain-- > 0) {
+		int len = 0;
+
+		if(cand >= 0) {
+			const quint8 *a = data + cand, *b = data + pos;
+			// Quick rejection on the byte that would improve the match
+			if(a[match_length] == b[match_length]) {
+				while(len < maxLen && a[len] == b[len]) {
+					++len;
+				}
+			}
+		} else {
+			while(len < maxLen && lzsByte(data, cand + len) == data[pos + len]) {
+				++len;
+			}
+		}
+
+		if(len > match_length) {
+			match_length = len;
+			match_position = cand;
+			if(len >= maxLen) {
+				break;
+			}
+		}
+
+		cand = prev[cand & 4095];
+	}
 }
 
-void LZS::clear()
+void LZS::initHashChain(const quint8 *data, int size)
+{
+	for(int i=0 ; i<4096 ; ++i) {
+		head[i] = LZS_NIL;
+	}
+
+	for(qint32 i=-LZS_MAX_MATCH ; i<0 && i + 2 < size ; ++i) {
+		insertHash(data, i);
+	}
+}
+
+int LZS::compressHashChain(const char *data, int size, char *out, int maxChain, bool lazy)
+{
+	const quint8 *input = (const quint8 *)data;
+	quint8 *output = (quint8 *)out;
+	quint8 *flags = output;
+	int curResult = 1, pos = 0, len, position;
+	bool hasMatch = false;
+	quint8 mask = 1;
+
+	if(size <= 0) {
+		return 0;
+	}
+
+	initHashChain(input, size);
+
+	*flags = 0;
+
+	while(pos < size) {
+		if(!hasMatch) {
+			findMatch(input, size, pos, maxChain);
+		}
+		hasMatch = false;
+		len = match_length;
+		position = match_position;
+
+		if(pos + 2 < size) {
+			insertHash(input, pos);
+		}
+
+		if(lazy && len >= LZS_MIN_MATCH && len < LZS_MAX_MATCH && pos + 1 < size) {
+			findMatch(input, size, pos + 1, maxChain);
+			if(match_length > len) {
+				len = 0; // Better match at next position: send one byte
+				hasMatch = true;
+			}
+		}
+
+		if(len >= LZS_MIN_MATCH) {
+			quint16 address = quint16((4078 + position) & 4095);
+			output[curResult++] = quint8(address);
+			output[curResult++] = quint8(((address >> 4) & 0xF0) | (len - LZS_MIN_MATCH));
+
+			for(int i=1 ; i<len ; ++i) {
+				if(pos + i + 2 < size) {
+					insertHash(input, pos + i);
+				}
+			}
+			pos += len;
+		} else {
+			*flags |= mask;
+			output[curResult++] = input[pos++];
+		}
+
+		if((mask <<= 1) == 0 && pos < size) {
+			flags = output + curResult;
+			*flags = 0;
+			++curResult;
+			mask = 1;
+		}
+	}
+
+	return curResult;
+}
+
+/* Optimal parse
+ * The longest match is searched exhaustively at every position, then the
+ * cheapest sequence of literals and references is computed backward by
+ * dynamic programming. The state is (position, units already in the current
+ * group of 8), so the flag byte opening each group is counted exactly and
+ * the result is the smallest output for the available matches. */
+
+int LZS::compressOptimal(const char *data, int size, char *out)
 {
-	result.clear();
+	const quint8 *input = (const quint8 *)data;
+	quint8 *output = (quint8 *)out;
+	quint8 *flags = output;
+	int curResult = 1, pos, group;
+	quint8 mask = 1;
+
+	if(size <= 0) {
+		return 0;
+	}
+
+	QVector<quint8> lengths(size);
+	QVector<qint32> positions(size);
+
+	initHashChain(input, size);
+
+	for(pos=0 ; pos<size ; ++pos) {
+		findMatch(input, size, pos, 4096);
+		lengths[pos] = quint8(match_length >= LZS_MIN_MATCH ? match_length : 0);
+		positions[pos] = match_position;
+		if(pos + 2 < size) {
+			insertHash(input, pos);
+		}
+	}
+
+	// cost[pos * 8 + group]: size in bytes to encode data[pos..size-1]
+	// when group units are already written since the last flag byte
+	QVector<quint32> cost((size + 1) * 8, 0);
+	QVector<quint8> choice(size * 8);
+
+	for(pos=size-1 ; pos>=0 ; --pos) {
+		for(group=0 ; group<8 ; ++group) {
+			const quint32 flagCost = group == 0 ? 1 : 0;
+			const int nextGroup = (group + 1) & 7;
+			quint32 best = flagCost + 1 + cost[(pos + 1) * 8 + nextGroup];
+			quint8 bestLen = 1;
+
+			for(int len=LZS_MIN_MATCH ; len<=lengths[pos] ; ++len) {
+				quint32 c = flagCost + 2 + cost[(pos + len) * 8 + nextGroup];
+				if(c <= best) {
+					best = c;
+					bestLen = quint8(len);
+				}
+			}
+
+			cost[pos * 8 + group] = best;
+			choice[pos * 8 + group] = bestLen;
+		}
+	}
+
+	*flags = 0;
+	pos = group = 0;
+
+	while(pos < size) {
+		int len = choice[pos * 8 + group];
+
+		if(len >= LZS_MIN_MATCH) {
+			quint16 address = quint16((4078 + positions[pos]) & 4095);
+			output[curResult++] = quint8(address);
+			output[curResult++] = quint8(((address >> 4) & 0xF0) | (len - LZS_MIN_MATCH));
+			pos += len;
+		} else {
+			*flags |= mask;
+			output[curResult++] = input[pos++];
+		}
+
+		group = (group + 1) & 7;
+
+		if((mask <<= 1) == 0 && pos < size) {
+			flags = output + curResult;
+			*flags = 0;
+			++curResult;
+			mask = 1;
+		}
+	}
+
+	return curResult;
+}
+
+LZSEncoder::LZSEncoder(LZS::Level level) :
+	_lzs(new LZS())
+{
+	switch(level) {
+	case LZS::Fast:
+		_maxChain = 4;
+		_lazy = false;
+		break;
+	case LZS::Default:
+		_maxChain = 128;
+		_lazy = true;
+		break;
+	default:
+		_maxChain = 4096;
+		_lazy = true;
+		break;
+	}
+
+	reset();
+}
+
+LZSEncoder::~LZSEncoder()
+{
+	delete _lzs;
+}
+
+void LZSEncoder::reset()
+{
+	_started = _hasMatch = false;
+	_buffer.clear();
+	_pos = 0;
+	_totalIn = 0;
+	_group[0] = 0;
+	_groupSize = 1;
+	_mask = 1;
+}
+
+void LZSEncoder::write(const char *data, int size, QByteArray &out)
+{
+	_buffer.append(data, size);
+	_totalIn += size;
+	process(out, false);
+}
+
+void LZSEncoder::write(const QByteArray &data, QByteArray &out)
+{
+	write(data.constData(), data.size(), out);
+}
+
+void LZSEncoder::finish(QByteArray &out)
+{
+	process(out, true);
+
+	if(_groupSize > 1) {
+		out.append((const char *)_group, _groupSize);
+	}
+
+	reset();
+}
+
+void LZSEncoder::process(QByteArray &out, bool finish)
+{
+	const quint8 *input = (const quint8 *)_buffer.constData();
+	const int size = _buffer.size();
+	// Enough data to find a match at the next position and to hash the whole match
+	const int lookahead = finish ? 0 : LZS_MAX_MATCH + 2;
+	int len, position;
+
+	if(!_started) {
+		if(size < lookahead || size == 0) {
+			return;
+		}
+		_lzs->initHashChain(input, size);
+		_started = true;
+	}
+
+	while(_pos < size && size - _pos >= lookahead) {
+		if(!_hasMatch) {
+			_lzs->findMatch(input, size, _pos, _maxChain);
+		}
+		_hasMatch = false;
+		len = _lzs->match_length;
+		position = _lzs->match_position;
+
+		if(_pos + 2 < size) {
+			_lzs->insertHash(input, _pos);
+		}
+
+		if(_lazy && len >= LZS_MIN_MATCH && len < LZS_MAX_MATCH && _pos + 1 < size) {
+			_lzs->findMatch(input, size, _pos + 1, _maxChain);
+			if(_lzs->match_length > len) {
+				len = 0; // Better match at next position: send one byte
+				_hasMatch = true;
+			}
+		}
+
+		if(len >= LZS_MIN_MATCH) {
+			quint16 address = quint16((4078 + _totalIn - size + position) & 4095);
+			_group[_groupSize++] = quint8(address);
+			_group[_groupSize++] = quint8(((address >> 4) & 0xF0) | (len - LZS_MIN_MATCH));
+
+			for(int i=1 ; i<len ; ++i) {
+				if(_pos + i + 2 < size) {
+					_lzs->insertHash(input, _pos + i);
+				}
+			}
+			_pos += len;
+		} else {
+			_group[0] |= _mask;
+			_group[_groupSize++] = input[_pos++];
+		}
+
+		if((_mask <<= 1) == 0) {
+			out.append((const char *)_group, _groupSize);
+			_group[0] = 0;
+			_groupSize = 1;
+			_mask = 1;
+		}
+	}
+
+	slide();
+}
+
+void LZSEncoder::slide()
+{
+	// Keep at least the last 4096 bytes as history, the offset is
+	// a multiple of 4096 to keep the indexes of the prev array
+	const int offset = (_pos - 4096) & ~4095;
+
+	if(offset < 65536) {
+		return;
+	}
+
+	_buffer.remove(0, offset);
+	_pos -= offset;
+
+	for(int i=0 ; i<4096 ; ++i) {
+		if(_lzs->head[i] != LZS_NIL) {
+			_lzs->head[i] = qMax(_lzs->head[i] - offset, -LZS_WINDOW * 2);
+		}
+		if(_lzs->prev[i] != LZS_NIL) {
+			_lzs->prev[i] = qMax(_lzs->prev[i] - offset, -LZS_WINDOW * 2);
+		}
+	}
+	_lzs->match_position -= offset;
+}
+
+LZSDecoder::LZSDecoder(qint64 max) :
+	_max(max)
+{
+	reset();
+}
+
+void LZSDecoder::reset()
+{
+	memset(_textBuf, 0, 4096);
+	_curBuff = 4078;
+	_premOctet = 0;
+	_pending = -1;
+	_totalOut = 0;
+}
+
+bool LZSDecoder::write(const char *data, int size, QByteArray &out)
+{
+	const quint8 *fileData = (const quint8 *)data;
+	const quint8 *endFileData = fileData + size;
+	qint64 remaining = _max < 0 ? Q_INT64_C(0x7FFFFFFFFFFFFFFF) : _max - _totalOut;
+	const int start = out.size();
+	int curResult = start;
+
+	if(remaining <= 0) {
+		return false;
+	}
+
+	// At most 9 bytes per byte of input
+	out.resize(start + int(qMin(qint64(size) * 9 + 18, remaining)));
+	quint8 *result = (quint8 *)out.data();
+	const int max = out.size();
+
+	while(curResult < max)
+	{
+		if(_pending < 0) {
+			// The flags are shifted after each unit, so a chunk can end anywhere
+			if((_premOctet & 256) == 0) {
+				if(fileData >= endFileData) {
+					break;
+				}
+				_premOctet = *fileData++ | 0xff00;
+			}
+
+			if(fileData >= endFileData) {
+				break;
+			}
+
+			if(_premOctet & 1)
+			{
+				result[curResult++] = _textBuf[_curBuff] = *fileData++;
+				_curBuff = (_curBuff + 1) & 4095;
+				_premOctet >>= 1;
+				continue;
+			}
+
+			_pending = *fileData++;
+		}
+
+		if(fileData >= endFileData) {
+			break; // Second byte of the reference in the next chunk
+		}
+
+		quint16 adresse = quint16(_pending | ((*fileData & 0xF0) << 4));
+		int length = (*fileData++ & 0xF) + 3;
+		_pending = -1;
+		_premOctet >>= 1;
+
+		for(int i=0 ; i<length && curResult < max ; ++i)
+		{
+			result[curResult++] = _textBuf[_curBuff] = _textBuf[(adresse + i) & 4095];
+			_curBuff = (_curBuff + 1) & 4095;
+		}
+	}
+
+	_totalOut += curResult - start;
+	out.truncate(curResult);
+
+	return !isFinished();
+}
+
+bool LZSDecoder::write(const QByteArray &data, QByteArray &out)
+{
+	return write(data.constData(), data.size(), out);
+}
+
+bool LZS::compress(const QByteArray &data, QByteArray &out, Level level)
+{
+	try {
+		out.resize(compressBound(data.size()));
+	} catch(const std::bad_alloc &) {
+		out.clear();
+		return false;
+	}
+
+	out.truncate(compress(data.constData(), data.size(), out.data(), level));
+
+	return true;
+}
+
+QByteArray LZS::compress(const QByteArray &data, Level level)
+{
+	QByteArray result;
+	LZS *lzs = new LZS();
+	lzs->compress(data, result, level);
+	delete lzs;
+	return result;
 }
@@ -32,20 +32,103 @@
 class LZS
 {
 public:
-	static const QByteArray &decompress(const QByteArray &fileData, int max);
-	static const QByteArray &decompressAll(const QByteArray &fileData);
-	static const QByteArray &compress(const QByteArray &fileData);
-	static void clear();
+	enum Level {
+		Tree,		// Okumura binary trees, greedy (historical encoder, default)
+		Fast,		// Hash chains, short search, greedy
+		Default,	// Hash chains, lazy matching
+		Best,		// Hash chains, exhaustive search, lazy matching
+		Optimal		// Exhaustive search, cheapest parse (slowest, smallest output)
+	};
+
+	LZS();
+	// Compress size bytes of data into out, which must hold compressBound(size) bytes.
+	// Returns the compressed size.
+	int compress(const char *data, int size, char *out, Level level = Tree);
+	bool compress(const QByteArray &data, QByteArray &out, Level level = Tree);
+
+	static int compressBound(int size);
+	// Decompress at most max bytes into out, returns the decompressed size
+	static int decompress(const char *data, int size, char *out, int max);
+	static bool decompress(const QByteArray &data, QByteArray &out, int max);
+	static bool decompressAll(const QByteArray &data, QByteArray &out);
+	// Convenience functions, reentrant (one codec per call)
+	static QByteArray decompress(const QByteArray &data, int max);
+	static QByteArray decompressAll(const QByteArray &data);
+	static QByteArray compress(const QByteArray &data, Level level = Tree);
+private:
+	friend class LZSEncoder;
+	int compressTree(const char *data, int size, char *out);
+	int compressHashChain(const char *data, int size, char *out, int maxChain, bool lazy);
+	int compressOptimal(const char *data, int size, char *out);
+	void initHashChain(const quint8 *data, int size);
+	inline void insertHash(const quint8 *data, qint32 pos);
+	void findMatch(const quint8 *data, int size, qint32 pos, int maxChain);
+	void InsertNode(qint32 r);
+	void DeleteNode(qint32 p);
+	qint32 match_length;//of longest match. These are set by the InsertNode() procedure.
+	qint32 match_position;
+	qint32 lson[4097];//left & right children & parents -- These constitute binary search trees.
+	qint32 rson[4353];
+	qint32 dad[4097];
+	unsigned char text_buf[4113];//ring buffer of size 4096, with extra 17 bytes to facilitate string comparison
+	qint32 head[4096];//most recent position for each hash of 3 bytes
+	qint32 prev[4096];//previous position with the same hash, indexed by position modulo 4096
+};
+
+// Incremental compression: the data can be written in several chunks,
+// the output is the same as LZS::compress with the same level.
+// Tree and Optimal levels need the whole data and are replaced by Best.
+class LZSEncoder
+{
+public:
+	explicit LZSEncoder(LZS::Level level = LZS::Best);
+	virtual ~LZSEncoder();
+	void reset();
+	// Append to out the compressed data that is ready
+	void write(const char *data, int size, QByteArray &out);
+	void write(const QByteArray &data, QByteArray &out);
+	// End of the stream, append to out the remaining compressed data
+	void finish(QByteArray &out);
+	inline qint64 totalIn() const {
+		return _totalIn;
+	}
+private:
+	Q_DISABLE_COPY(LZSEncoder)
+	void process(QByteArray &out, bool finish);
+	void slide();
+
+	LZS *_lzs;
+	int _maxChain;
+	bool _lazy, _started, _hasMatch;
+	QByteArray _buffer;//history (at most 4096 bytes) + data to compress
+	int _pos;//next position to compress in _buffer
+	qint64 _totalIn;
+	quint8 _group[17];//flag byte + 8 units
+	int _groupSize;
+	quint8 _mask;
+};
+
+// Incremental decompression
+class LZSDecoder
+{
+public:
+	explicit LZSDecoder(qint64 max = -1);
+	void reset();
+	// Append to out the data decompressed from this chunk,
+	// returns false when max bytes were decompressed
+	bool write(const char *data, int size, QByteArray &out);
+	bool write(const QByteArray &data, QByteArray &out);
+	inline qint64 totalOut() const {
+		return _totalOut;
+	}
+	inline bool isFinished() const {
+		return _max >= 0 && _totalOut >= _max;
+	}
 private:
-	static void InsertNode(qint32 r);
-	static void DeleteNode(qint32 p);
-	static qint32 match_length;//of longest match. These are set by the InsertNode() procedure.
-	static qint32 match_position;
-	static qint32 lson[4097];//left & right children & parents -- These constitute binary search trees.
-	static qint32 rson[4353];
-	static qint32 dad[4097];
-	static unsigned char text_buf[4113];//ring buffer of size 4096, with extra 17 bytes to facilitate string comparison
-	static QByteArray result;
+	quint8 _textBuf[4096];//ring buffer
+	quint16 _curBuff, _premOctet;
+	int _pending;//first byte of a reference split between two chunks, or -1
+	qint64 _max, _totalOut;
 };
 
 #endif
@@ -0,0 +1,149 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#include "LZSDevice.h"
+
+#define CHUNK_SIZE	4096
+
+LZSDevice::LZSDevice(QIODevice *device, LZS::Level level) :
+	_device(device), _encoder(level), _bufferPos(0), _max(-1), _compressedSize(0)
+{
+}
+
+LZSDevice::~LZSDevice()
+{
+	close();
+}
+
+bool LZSDevice::open(OpenMode mode)
+{
+	if((mode & ReadWrite) == ReadWrite || (mode & Append)) {
+		setErrorString(QObject::tr("Mode d'ouverture non supporté"));
+		return false;
+	}
+
+	if(!_device->isOpen() && !_device->open(mode)) {
+		setErrorString(_device->errorString());
+		return false;
+	}
+
+	_encoder.reset();
+	_decoder = LZSDecoder(_max);
+	_buffer.clear();
+	_bufferPos = 0;
+	_compressedSize = 0;
+
+	return QIODevice::open(mode | Unbuffered);
+}
+
+void LZSDevice::close()
+{
+	if(!isOpen()) {
+		return;
+	}
+
+	if(openMode() & WriteOnly) {
+		QByteArray out;
+		_encoder.finish(out);
+		if(!out.isEmpty()) {
+			_device->write(out);
+			_compressedSize += out.size();
+		}
+	}
+
+	QIODevice::close();
+}
+
+bool LZSDevice::isSequential() const
+{
+	return true;
+}
+
+bool LZSDevice::atEnd() const
+{
+	return bytesAvailable() == 0
+	        && (_decoder.isFinished() || _device->atEnd());
+}
+
+qint64 LZSDevice::bytesAvailable() const
+{
+	return _buffer.size() - _bufferPos + QIODevice::bytesAvailable();
+}
+
+void LZSDevice::setMaximumSize(qint64 max)
+{
+	_max = max;
+}
+
+bool LZSDevice::fillBuffer()
+{
+	char chunk[CHUNK_SIZE];
+
+	_buffer.clear();
+	_bufferPos = 0;
+
+	while(_buffer.isEmpty() && !_decoder.isFinished()) {
+		qint64 r = _device->read(chunk, CHUNK_SIZE);
+		if(r <= 0) {
+			return false;
+		}
+		_compressedSize += r;
+		_decoder.write(chunk, int(r), _buffer);
+	}
+
+	return !_buffer.isEmpty();
+}
+
+qint64 LZSDevice::readData(char *data, qint64 maxSize)
+{
+	qint64 read = 0;
+
+	while(read < maxSize) {
+		if(_bufferPos >= _buffer.size() && !fillBuffer()) {
+			break;
+		}
+
+		int size = int(qMin(maxSize - read, qint64(_buffer.size() - _bufferPos)));
+		memcpy(data + read, _buffer.constData() + _bufferPos, size);
+		_bufferPos += size;
+		read += size;
+	}
+
+	return read;
+}
+
+qint64 LZSDevice::writeData(const char *data, qint64 maxSize)
+{
+	QByteArray out;
+	qint64 written = 0;
+
+	while(written < maxSize) {
+		int size = int(qMin(maxSize - written, qint64(CHUNK_SIZE)));
+		out.clear();
+		_encoder.write(data + written, size, out);
+		if(!out.isEmpty()) {
+			if(_device->write(out) != out.size()) {
+				setErrorString(_device->errorString());
+				return written > 0 ? written : -1;
+			}
+			_compressedSize += out.size();
+		}
+		written += size;
+	}
+
+	return written;
+}
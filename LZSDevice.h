@@ -0,0 +1,57 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef LZSDEVICE_H
+#define LZSDEVICE_H
+
+#include <QtCore>
+#include "LZS.h"
+
+// Sequential device that decompresses the LZS data read from device,
+// or compresses the data written to device.
+// The compressed stream ends when the LZSDevice is closed.
+class LZSDevice : public QIODevice
+{
+public:
+	explicit LZSDevice(QIODevice *device, LZS::Level level = LZS::Best);
+	virtual ~LZSDevice();
+	virtual bool open(OpenMode mode);
+	virtual void close();
+	virtual bool isSequential() const;
+	virtual bool atEnd() const;
+	virtual qint64 bytesAvailable() const;
+	// Maximum size of decompressed data (ReadOnly mode)
+	void setMaximumSize(qint64 max);
+	// Bytes read from or written to device
+	inline qint64 compressedSize() const {
+		return _compressedSize;
+	}
+protected:
+	virtual qint64 readData(char *data, qint64 maxSize);
+	virtual qint64 writeData(const char *data, qint64 maxSize);
+private:
+	bool fillBuffer();
+
+	QIODevice *_device;
+	LZSEncoder _encoder;
+	LZSDecoder _decoder;
+	QByteArray _buffer;
+	int _bufferPos;
+	qint64 _max, _compressedSize;
+};
+
+#endif // LZSDEVICE_H
@@ -17,6 +17,38 @@
  ****************************************************************************/
 
 #include "AllEditor.h"
+#include "../SaveFields.h"
+
+// Part of MAIN edited in each tab
+struct AllEditorPage {
+	int offset, size;
+};
+
+#define MAIN_FIELD(path) \
+	{ SaveFields::offset(SaveFields::mainStruct, path), SaveFields::field(SaveFields::mainStruct, path).size }
+
+static constexpr AllEditorPage pages[] = {
+	{ 0, sizeof(MAIN) },// All
+//	MAIN_FIELD("misc1"),
+	// Misc 2/Positions: from u6 to the end of MISC2
+	{ SaveFields::offset(SaveFields::mainStruct, "misc2.u6"),
+	  sizeof(MISC2) - SaveFields::offset(SaveFields::misc2Struct, "u6") },
+	MAIN_FIELD("shops"),
+	MAIN_FIELD("misc3"),
+	MAIN_FIELD("field"),
+	MAIN_FIELD("worldmap"),
+	MAIN_FIELD("chocobo")/*,
+	MAIN_FIELD("gfs"),
+	MAIN_FIELD("persos"),
+	MAIN_FIELD("limitb"),
+	MAIN_FIELD("items"),
+	MAIN_FIELD("config")*/
+};
+
+static const AllEditorPage &page(int index)
+{
+	return pages[index > 0 && index < int(sizeof(pages) / sizeof(*pages)) ? index : 0];
+}
 
 AllEditor::AllEditor(QWidget *parent)
 	: PageWidget(parent)
@@ -55,125 +87,13 @@ void AllEditor::buildWidget()
 
 void AllEditor::fillPage()
 {
-	char *cur;
-
-	switch(tabBar->currentIndex()) {
-//	case 1:// Header
-//		hexEdit->setData(QByteArray((char *)descData, sizeof(*descData)));
-//		break;
-//	case 1:// Misc 1
-//		cur = (char *)data + 2724;
-//		hexEdit->setData(QByteArray(cur, 32));
-//		break;
-	case 1:// Misc 2/Positions
-		cur = (char *)data + /*3200*/3308;
-		hexEdit->setData(QByteArray(cur, /*144*/36));
-		break;
-	case 2:// Shops
-		cur = (char *)data + 2304;
-		hexEdit->setData(QByteArray(cur, 400));
-		break;
-	case 3:// Misc
-		cur = (char *)data + 3344;
-		hexEdit->setData(QByteArray(cur, 256));
-		break;
-	case 4:// Field Vars
-		cur = (char *)data + 3600;
-		hexEdit->setData(QByteArray(cur, 1024));
-		break;
-	case 5:// WorldMap Vars
-		cur = (char *)data + 4624;
-		hexEdit->setData(QByteArray(cur, 128));
-		break;
-	case 6:// Chocobo World
-		cur = (char *)data + 4880;
-		hexEdit->setData(QByteArray(cur, 64));
-		break;
-	/*case 6:// GF
-		hexEdit->setData(QByteArray((char *)data, 1088));
-		break;
-	case 7:// Characters
-		cur = (char *)data + 1088;
-		hexEdit->setData(QByteArray(cur, 1216));
-		break;
-	case 8:// Limit Break
-		cur = (char *)data + 2756;
-		hexEdit->setData(QByteArray(cur, 16));
-		break;
-	case 9:// Item
-		cur = (char *)data + 2772;
-		hexEdit->setData(QByteArray(cur, 428));
-		break;
-	case 10:// Config
-		cur = (char *)data + 2704;
-		hexEdit->setData(QByteArray(cur, 20));
-		break;*/
-	default:// All
-		hexEdit->setData(QByteArray(/*(char *)descData, sizeof(*descData)).append(*/(char *)data, sizeof(*data)));
-		break;
-	}
+	const AllEditorPage &cur = page(tabBar->currentIndex());
+	hexEdit->setData(QByteArray((char *)data + cur.offset, cur.size));
 }
 
 void AllEditor::savePage()
 {
-	const char *hexdata = hexEdit->data().constData();
-	char *cur;
-
-	switch(tabBar->currentIndex()) {
-//	case 1:// Header
-//		memcpy(descData, hexdata, sizeof(*descData));
-//		break;
-//	case 1:// Misc 1
-//		cur = (char *)data + 2724;
-//		memcpy(cur, hexdata, 32);
-//		break;
-	case 1:// Misc 2/Position
-		cur = (char *)data + 3308;
-		memcpy(cur, hexdata, 36);
-		break;
-	case 2:// Shops
-		cur = (char *)data + 2304;
-		memcpy(cur, hexdata, 400);
-		break;
-	case 3:// Misc
-		cur = (char *)data + 3344;
-		memcpy(cur, hexdata, 256);
-		break;
-	case 4:// Field Vars
-		cur = (char *)data + 3600;
-		memcpy(cur, hexdata, 1024);
-		break;
-	case 5:// WorldMap Vars
-		cur = (char *)data + 4624;
-		memcpy(cur, hexdata, 128);
-		break;
-	case 6:// Chocobo World
-		cur = (char *)data + 4880;
-		memcpy(cur, hexdata, 64);
-		break;
-	/*case 6:// GF
-		memcpy(data, hexdata, 1088);
-		break;
-	case 7:// Characters
-		cur = (char *)data + 1088;
-		memcpy(cur, hexdata, 1216);
-		break;
-	case 8:// Limit Break
-		cur = (char *)data + 2756;
-		memcpy(cur, hexdata, 16);
-		break;
-	case 9:// Item
-		cur = (char *)data + 2772;
-		memcpy(cur, hexdata, 428);
-		break;
-	case 10:// Config
-		cur = (char *)data + 2704;
-		memcpy(&data[2704], hexdata, 20);
-		break;*/
-	default:// All
-//		memcpy(descData, hexdata, sizeof(*descData));
-//		hexdata += sizeof(*descData);
-		memcpy(data, hexdata, sizeof(*data));
-		break;
-	}
+	const AllEditorPage &cur = page(tabBar->currentIndex());
+	const QByteArray hexdata = hexEdit->data();
+	memcpy((char *)data + cur.offset, hexdata.constData(), qMin(hexdata.size(), cur.size));
 }
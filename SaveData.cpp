@@ -17,31 +17,48 @@
  ****************************************************************************/
 
 #include "SaveData.h"
+#include "Crc16.h"
 #include "FF8Text.h"
 #include "Data.h"
 #include "LZS.h"
 
 SaveData::SaveData() :
-	_freqValue(60), _id(0), _isFF8(false), _isDelete(false),
+	_freqValue(60), _id(0), _checksum(0), _isFF8(false), _isDelete(false),
 	_isTheLastEdited(false), _hasExistsInfos(true), _isRaw(false),
-	_isModified(false), _wasModified(false), _descriptionAuto(true), _previewAuto(true)
+	_isModified(false), _wasModified(false), _descriptionAuto(true), _previewAuto(true),
+	_descParsed(true), _mainParsed(true), _sharedData(false)
 {
 }
 
-SaveData::SaveData(int id, const QByteArray &data, const QByteArray &MCHeader, bool hasExistsInfos, bool isRaw) :
-	_freqValue(60), _id(id), _isFF8(false), _isDelete(false),
+SaveData::SaveData(int id, const QByteArray &data, const QByteArray &MCHeader, bool hasExistsInfos, bool isRaw,
+                   bool sharedData, bool lazy) :
+	_freqValue(60), _id(id), _checksum(0), _isFF8(false), _isDelete(false),
 	_isTheLastEdited(false), _hasExistsInfos(hasExistsInfos), _isRaw(isRaw),
-	_isModified(false), _wasModified(false), _descriptionAuto(true), _previewAuto(true)
+	_isModified(false), _wasModified(false), _descriptionAuto(true), _previewAuto(true),
+	_descParsed(true), _mainParsed(true), _sharedData(false)
 {
-	open(data, MCHeader);
+	open(data, MCHeader, sharedData, lazy);
 }
 
-void SaveData::open(const QByteArray &data, const QByteArray &MCHeader)
+/*
+ * When sharedData is true, data and MCHeader are not owned
+ * (QByteArray::fromRawData) and must stay valid until detachData()
+ * is called. The header and the raw save data reference them
+ * instead of copying, the icon is always copied because it is
+ * shared with the widgets.
+ * When lazy is true, only the magic numbers are checked here, the
+ * icon, HEADER and MAIN are decoded on first access.
+ */
+void SaveData::open(const QByteArray &data, const QByteArray &MCHeader, bool sharedData, bool lazy)
 {
 	_isModified = _isDelete = _isFF8 = false;
+	_sharedData = sharedData;
+	_saveCache.clear();
 	_header.clear();
 	_icon.setData(QByteArray());
 	_saveData.clear();
+	_rawData.clear();
+	_descParsed = _mainParsed = true;
 
 	_MCHeader = MCHeader;
 	setMCHeader(MCHeader);
@@ -49,11 +66,15 @@ void SaveData::open(const QByteArray &data, const QByteArray &MCHeader)
 
 	if(!_isRaw) {
 		if(data.size() >= FF8SAVE_SIZE && data.startsWith("SC")) {
-			_isFF8 = setData(data);
+			_isFF8 = isFF8Data(data);
+			memcpy(&_checksum, data.constData() + 384, 2);
 
 			if(_isFF8 || !_isDelete) {
-				_header = data.left(96);
-				_icon.setData(data.mid(96, 416));
+				_header = sharedData
+				        ? QByteArray::fromRawData(data.constData(), 96)
+				        : data.left(96);
+				_rawData = data;
+				_descParsed = _mainParsed = false;
 
 				switch((quint8)data.at(2)) {
 				case 0x11:
@@ -72,62 +93,121 @@ void SaveData::open(const QByteArray &data, const QByteArray &MCHeader)
 		}
 	}
 
+	if(!lazy) {
+		parseDesc();
+		parseMain();
+	}
+
 	if(!_isFF8) {
-		_saveData = hasSCHeader() ? data.mid(512) : data;
+		if(!hasSCHeader()) {
+			_saveData = data;
+		} else if(sharedData) {
+			_saveData = QByteArray::fromRawData(data.constData() + 512, qMax(0, data.size() - 512));
+		} else {
+			_saveData = data.mid(512);
+		}
 	}
 }
 
+void SaveData::detachData()
+{
+	if(!_sharedData) {
+		return;
+	}
+
+	_MCHeader = QByteArray(_MCHeader.constData(), _MCHeader.size());
+	_header = QByteArray(_header.constData(), _header.size());
+	if(!_rawData.isNull()) {
+		_rawData = QByteArray(_rawData.constData(), _rawData.size());
+	}
+	_saveData = QByteArray(_saveData.constData(), _saveData.size());
+	_sharedData = false;
+}
+
+// Copies data without going past end
+static char *append(char *out, const char *end, const QByteArray &data)
+{
+	const int size = qMin(data.size(), int(end - out));
+	memcpy(out, data.constData(), size);
+	return out + size;
+}
+
+/*
+ * The block is kept until the next modification, so saving a card
+ * only rebuilds the modified saves.
+ */
 QByteArray SaveData::save() const
 {
-	QByteArray ret;
+	if(_saveCache.isNull()) {
+		QByteArray ret(SAVE_SIZE, Qt::Uninitialized);
+		save(ret.data());
+		_saveCache = ret;
+	}
+
+	return _saveCache;
+}
+
+/*
+ * Writes the SAVE_SIZE bytes of the block directly in out.
+ */
+void SaveData::save(char *out) const
+{
+	if(!_saveCache.isNull()) {
+		memcpy(out, _saveCache.constData(), SAVE_SIZE);
+		return;
+	}
+
+	const char * const end = out + SAVE_SIZE;
+
+	parseDesc();
 
 	if(!_isFF8) {
-		ret.append(_header).append(_icon.data()).append(_saveData);
-		return ret.leftJustified(SAVE_SIZE, '\x00', true);
+		out = append(out, end, _header);
+		out = append(out, end, _icon.data());
+		out = append(out, end, _saveData);
+		memset(out, 0, end - out);
+		return;
 	}
 
+	parseMain();
+
+	Q_ASSERT(_header.size() == 96);
+
 	quint16 checksum = calcChecksum((char *)&_mainData);//On calcule le checksum à partir de la partie gf
 
-	ret.append("SC", 2);
-	ret.append(_header.at(2));// icon frames
-	ret.append('\x01');// slot count
+	memcpy(out, "SC", 2);
+	out[2] = _header.at(2);// icon frames
+	out[3] = '\x01';// slot count
 	if(_descriptionAuto) {
-		ret.append("\x82\x65\x82\x65\x82\x57\x81\x6D", 8);// FF8[
-		ret.append(FF8Text::numToBiosText(_id+1, 2));// II
-		ret.append("\x81\x6E\x81\x5E", 4);// ]/
-		ret.append(FF8Text::numToBiosText(Config::hour(_mainData.misc2.game_time, _freqValue), 2));// HH
-		ret.append("\x81\x46", 2);// :
-		ret.append(FF8Text::numToBiosText(Config::min(_mainData.misc2.game_time, _freqValue), 2));// MM
-		ret.append(_header.right(66));
+		memcpy(out + 4, "\x82\x65\x82\x65\x82\x57\x81\x6D", 8);// FF8[
+		FF8Text::numToBiosText(_id+1, 2, out + 12);// II
+		memcpy(out + 16, "\x81\x6E\x81\x5E", 4);// ]/
+		FF8Text::numToBiosText(Config::hour(_mainData.misc2.game_time, _freqValue), 2, out + 20);// HH
+		memcpy(out + 24, "\x81\x46", 2);// :
+		FF8Text::numToBiosText(Config::min(_mainData.misc2.game_time, _freqValue), 2, out + 26);// MM
+		memcpy(out + 30, _header.constData() + 30, 66);
 	} else {
-		ret.append(_header.right(92));
-	}
-	ret.append(_icon.data().leftJustified(288, '\0', true));
-	ret.append((char *)&checksum, 2);
-	ret.append("\xFF\x08", 2);
-	ret.append((char *)&_descData, sizeof(_descData));
-	ret.append((char *)&_mainData, sizeof(_mainData));
-	ret.append((char *)&checksum, 2);
-	ret.append(QByteArray(2782,'\x00'));
-
-	if(ret.size() != SAVE_SIZE) {
-		ret = ret.leftJustified(SAVE_SIZE, '\x00', true);
-		qWarning() << "Error saved save size" << ret.size() << SAVE_SIZE;
-		Q_ASSERT(false);
+		memcpy(out + 4, _header.constData() + 4, 92);
 	}
-
-	return ret;
+	char *iconEnd = append(out + 96, out + 384, _icon.data());
+	memset(iconEnd, 0, out + 384 - iconEnd);
+	memcpy(out + 384, &checksum, 2);
+	memcpy(out + 386, "\xFF\x08", 2);
+	memcpy(out + 388, &_descData, sizeof(_descData));
+	memcpy(out + 464, &_mainData, sizeof(_mainData));
+	memcpy(out + FF8SAVE_SIZE, &checksum, 2);
+	memset(out + FF8SAVE_SIZE + 2, 0, SAVE_SIZE - FF8SAVE_SIZE - 2);
 }
 
 void SaveData::remove()
 {
 	open(QByteArray(), hasMCHeader() ? emptyMCHeader() : QByteArray());
-	_isModified = true;
+	setModified(true);
 }
 
 void SaveData::restore()
 {
-	_isModified = true;
+	setModified(true);
 	_isDelete = false;
 	_MCHeader.replace(0, 10, QByteArray("\x51\x00\x00\x00\x00\x20\x00\x00\xff\xff", 10));
 	_MCHeader.replace(28, 99, QByteArray(99, '\x00'));
@@ -183,7 +263,7 @@ QByteArray SaveData::emptyMCHeader()
 void SaveData::setMCHeader(const QByteArray &MCHeader)
 {
 	if(_MCHeader != MCHeader) {
-		_isModified = true;
+		setModified(true);
 		_MCHeader = MCHeader;
 	}
 
@@ -237,27 +317,36 @@ void SaveData::setMCHeader(bool exists, char country, const QString &code, const
 
 HEADER &SaveData::descData()
 {
+	parseDesc();
+	_saveCache.clear();
 	return _descData;
 }
 
 const HEADER &SaveData::constDescData() const
 {
+	parseDesc();
 	return _descData;
 }
 
 MAIN &SaveData::mainData()
 {
+	parseMain();
+	_saveCache.clear();
 	return _mainData;
 }
 
 const MAIN &SaveData::constMainData() const
 {
+	parseMain();
 	return _mainData;
 }
 
 void SaveData::updateDescData()
 {
 	if(_previewAuto) {
+		parseDesc();
+		parseMain();
+
 		quint8 leader;
 		quint8 perso1 = _mainData.misc1.party[0];
 		quint8 perso2 = _mainData.misc1.party[1];
@@ -286,14 +375,16 @@ void SaveData::updateDescData()
 		_descData.time = _mainData.misc2.game_time;
 		_descData.disc = _mainData.misc3.disc - 1;
 
-		_isModified = true;
+		setModified(true);
 	}
 }
 
 void SaveData::setSaveData(const HEADER &descData, const MAIN &data)
 {
+	parseDesc();
+	parseMain();
 	if(memcmp(&descData, &_descData, sizeof(HEADER)) != 0 || memcmp(&data, &_mainData, sizeof(MAIN)) != 0) {
-		_isModified = true;
+		setModified(true);
 		_descData = descData;
 		_mainData = data;
 		updateDescData();
@@ -315,6 +406,9 @@ void SaveData::setModified(bool modified)
 	if(_isModified && !modified) {
 		_wasModified = true;
 	}
+	if(modified) {
+		_saveCache.clear();
+	}
 	_isModified = modified;
 }
 
@@ -330,6 +424,9 @@ int SaveData::id() const
 
 void SaveData::setId(int id)
 {
+	if(_id != id) {
+		_saveCache.clear(); // Description
+	}
 	_id = id;
 }
 
@@ -358,6 +455,14 @@ bool SaveData::isRaw() const
 	return _isRaw;
 }
 
+/*
+ * Compares the checksum read from the file with the current MAIN data.
+ */
+bool SaveData::isChecksumValid() const
+{
+	return !_isFF8 || calcChecksum((const char *)&constMainData()) == _checksum;
+}
+
 bool SaveData::hasSCHeader() const
 {
 	return !_header.isEmpty();
@@ -372,7 +477,7 @@ void SaveData::setBlockCount(quint8 blockCount)
 {
 	if(hasSCHeader()) {
 		_header[3] = blockCount;
-		_isModified = true;
+		setModified(true);
 	}
 }
 
@@ -417,7 +522,7 @@ void SaveData::setShortDescription(const QString &desc)
 
 		if(_header.mid(4, 64) != desc_data) {
 			_header.replace(4, 64, desc_data);
-			_isModified = true;
+			setModified(true);
 		}
 	}
 }
@@ -429,19 +534,24 @@ bool SaveData::isDescriptionAuto() const
 
 void SaveData::setDescriptionAuto(bool descAuto)
 {
+	if(_descriptionAuto != descAuto) {
+		_saveCache.clear();
+	}
 	_descriptionAuto = descAuto;
 }
 
 const SaveIconData &SaveData::saveIcon() const
 {
+	parseDesc();
 	return _icon;
 }
 
 void SaveData::setSaveIcon(const SaveIconData &saveIconData)
 {
+	parseDesc();
 	if(_icon.data() != saveIconData.data()) {
 		_icon = saveIconData;
-		_isModified = true;
+		setModified(true);
 	}
 }
 
@@ -450,34 +560,61 @@ bool SaveData::isFF8() const
 	return _isFF8;
 }
 
-bool SaveData::setData(const QByteArray &data)
+bool SaveData::isFF8Data(const QByteArray &data)
 {
-	const char *access_data = data.constData();
+	Q_STATIC_ASSERT(sizeof(HEADER) == 76);
+	Q_STATIC_ASSERT(sizeof(MAIN) == 4944);
+
 	//ff8
 	quint16 ff8;
-	memcpy(&ff8, &access_data[386], 2);
+	memcpy(&ff8, data.constData() + 386, 2);
 	// PC Demo is 0xFF8
-	if(ff8 != 0x8FF && ff8 != 0xFF8)		return false;
+	return ff8 == 0x8FF || ff8 == 0xFF8;
+}
+
+// Icon + HEADER
+void SaveData::parseDesc() const
+{
+	if(_descParsed) {
+		return;
+	}
+
+	const char *access_data = _rawData.constData();
 
-	if(sizeof(_descData)!=76) {
-		qWarning() << "error desc structure" << sizeof(_descData);
-		return false;
+	_icon.setData(QByteArray(access_data + 96, 416));
+	if(_isFF8) {
+		memcpy(&_descData, access_data + 388, sizeof(_descData));
 	}
 
-	memcpy(&_descData, &access_data[388], sizeof(_descData));
+	_descParsed = true;
+	releaseRawData();
+}
+
+void SaveData::parseMain() const
+{
+	if(_mainParsed) {
+		return;
+	}
 
-	if(sizeof(_mainData)!=4944) {
-		qWarning() << "error main structure" << sizeof(_mainData);
-		return false;
+	if(_isFF8) {
+		memcpy(&_mainData, _rawData.constData() + 464, sizeof(_mainData));
 	}
 
-	memcpy(&_mainData, &access_data[464], sizeof(_mainData));
+	_mainParsed = true;
+	releaseRawData();
+}
 
-	return true;
+void SaveData::releaseRawData() const
+{
+	if(_descParsed && _mainParsed) {
+		_rawData.clear();
+	}
 }
 
 QString SaveData::perso(quint8 index) const
 {
+	parseDesc();
+	parseMain();
 	switch(index) {
 	case SQUALL:		return FF8Text::toString((char *)_descData.squall, isJp());
 	case RINOA:			return FF8Text::toString((char *)_descData.rinoa, isJp());
@@ -492,6 +629,7 @@ QString SaveData::perso(quint8 index) const
 
 QString SaveData::gf(quint8 index) const
 {
+	parseMain();
 	return FF8Text::toString((char *)_mainData.gfs[index].name, isJp());
 }
 
@@ -501,7 +639,9 @@ void SaveData::setGf(quint8 index, const QString &name)
 			.leftJustified(11, '\x00', true)
 			.append('\x00').constData();
 
+	parseMain();
 	memcpy(_mainData.gfs[index].name, gfName, 12);
+	_saveCache.clear();
 }
 
 void SaveData::setPerso(quint8 index, const QString &name)
@@ -510,6 +650,8 @@ void SaveData::setPerso(quint8 index, const QString &name)
 			.leftJustified(11, '\x00', true)
 			.append('\x00').constData();
 
+	parseDesc();
+	parseMain();
 	switch(index) {
 	case SQUALL:		memcpy(_descData.squall, persoName, 12);		break;
 	case RINOA:			memcpy(_descData.rinoa, persoName, 12);			break;
@@ -518,6 +660,7 @@ void SaveData::setPerso(quint8 index, const QString &name)
 	case ANGELO:		memcpy(_descData.angelo, persoName, 12);		break;
 	default:	break;
 	}
+	_saveCache.clear();
 }
 
 bool SaveData::isPreviewAuto() const
@@ -540,12 +683,5 @@ quint8 SaveData::xorByte(const char *data)
 
 quint16 SaveData::calcChecksum(const char *data)
 {
-	register quint16 crc = 0xFFFF, cur;
-
-	for(cur=0 ; cur<4944 ; ++cur)
-		crc = crcTab[(crc >> 8) ^ (quint8)*data++] ^ (crc << 8);
-
-	return ~crc;
+	return ~Crc16::ff8(data, 4944);
 }
-
-const quint16 SaveData::crcTab[256] = {0,4129,8258,12387,16516,20645,24774,28903,33032,37161,41290,45419,49548,53677,57806,61935,4657,528,12915,8786,21173,17044,29431,25302,37689,33560,45947,41818,54205,50076,62463,58334,9314,13379,1056,5121,25830,29895,17572,21637,42346,46411,34088,38153,58862,62927,50604,54669,13907,9842,5649,1584,30423,26358,22165,18100,46939,42874,38681,34616,63455,59390,55197,51132,18628,22757,26758,30887,2112,6241,10242,14371,51660,55789,59790,63919,35144,39273,43274,47403,23285,19156,31415,27286,6769,2640,14899,10770,56317,52188,64447,60318,39801,35672,47931,43802,27814,31879,19684,23749,11298,15363,3168,7233,60846,64911,52716,56781,44330,48395,36200,40265,32407,28342,24277,20212,15891,11826,7761,3696,65439,61374,57309,53244,48923,44858,40793,36728,37256,33193,45514,41451,53516,49453,61774,57711,4224,161,12482,8419,20484,16421,28742,24679,33721,37784,41979,46042,49981,54044,58239,62302,689,4752,8947,13010,16949,21012,25207,29270,46570,42443,38312,34185,62830,58703,54572,50445,13538,9411,5280,1153,29798,25671,21540,17413,42971,47098,34713,38840,59231,63358,50973,55100,9939,14066,1681,5808,26199,30326,17941,22068,55628,51565,63758,59695,39368,35305,47498,43435,22596,18533,30726,26663,6336,2273,14466,10403,52093,56156,60223,64286,35833,39896,43963,48026,19061,23124,27191,31254,2801,6864,10931,14994,64814,60687,56684,52557,48554,44427,40424,36297,31782,27655,23652,19525,15522,11395,7392,3265,61215,65342,53085,57212,44955,49082,36825,40952,28183,32310,20053,24180,11923,16050,3793};
@@ -30,7 +30,7 @@
 #define SAVE_SIZE			8192
 
 #include <QtCore>
-#include "SaveIcon.h"
+#include "SaveIconData.h"
 
 #ifdef _MSC_VER
 #	define PACK(structure)			\
@@ -456,10 +456,13 @@ class SaveData
 {
 public:
 	SaveData();
-	SaveData(int id, const QByteArray &data, const QByteArray &MCHeader, bool hasExistsInfos, bool isRaw);
+	SaveData(int id, const QByteArray &data, const QByteArray &MCHeader, bool hasExistsInfos, bool isRaw,
+	         bool sharedData=false, bool lazy=false);
 	// Operations
-	void open(const QByteArray &data, const QByteArray &MCHeader);
+	void open(const QByteArray &data, const QByteArray &MCHeader, bool sharedData=false, bool lazy=false);
+	void detachData();
 	QByteArray save() const;
+	void save(char *out) const;
 	void remove();
 	void restore();
 	// Informations
@@ -474,6 +477,7 @@ public:
 	bool isTheLastEdited() const;
 	bool hasExistsInfos() const;
 	bool isRaw() const;
+	bool isChecksumValid() const;
 	// MC Header
 	bool hasMCHeader() const;
 	const QByteArray &MCHeader() const;
@@ -502,6 +506,7 @@ public:
 	void setPerso(quint8 index, const QString &name);
 	QString gf(quint8 index) const;
 	void setGf(quint8 index, const QString &name);
+	// Call setModified(true) after writing in a reference kept from descData() or mainData()
 	HEADER &descData();
 	const HEADER &constDescData() const;
 	MAIN &mainData();
@@ -511,21 +516,30 @@ public:
 	bool isPreviewAuto() const;
 	void setPreviewAuto(bool prevAuto);
 private:
-	bool setData(const QByteArray &data);
+	static bool isFF8Data(const QByteArray &data);
+	void parseDesc() const;
+	void parseMain() const;
+	void releaseRawData() const;
 	static quint16 calcChecksum(const char *data);
-	static const quint16 crcTab[256];
 
 	QByteArray _MCHeader;
 	QByteArray _header;
-	SaveIconData _icon;
-	HEADER _descData;
-	MAIN _mainData;
+	// Lazy parsing: _rawData is decoded on first access
+	mutable QByteArray _rawData;
+	mutable SaveIconData _icon;
+	mutable HEADER _descData;
+	mutable MAIN _mainData;
 	int _freqValue, _id;
+	quint16 _checksum; // Read from the file
 	bool _isFF8, _isDelete, _isTheLastEdited;
 	bool _hasExistsInfos, _isRaw;
 	bool _isModified, _wasModified;
 	bool _descriptionAuto, _previewAuto;
+	mutable bool _descParsed, _mainParsed;
+	bool _sharedData;
 	QByteArray _saveData;
+	// Last block returned by save(), cleared by the modifications
+	mutable QByteArray _saveCache;
 };
 
 #endif
@@ -0,0 +1,115 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#include "SaveFields.h"
+
+// Definitions of the tables (C++11)
+constexpr SaveField SaveFields::gforcesFields[];
+constexpr SaveStruct SaveFields::gforcesStruct;
+constexpr SaveField SaveFields::personnagesFields[];
+constexpr SaveStruct SaveFields::personnagesStruct;
+constexpr SaveField SaveFields::shopFields[];
+constexpr SaveStruct SaveFields::shopStruct;
+constexpr SaveField SaveFields::configFields[];
+constexpr SaveStruct SaveFields::configStruct;
+constexpr SaveField SaveFields::misc1Fields[];
+constexpr SaveStruct SaveFields::misc1Struct;
+constexpr SaveField SaveFields::limitbFields[];
+constexpr SaveStruct SaveFields::limitbStruct;
+constexpr SaveField SaveFields::itemsFields[];
+constexpr SaveStruct SaveFields::itemsStruct;
+constexpr SaveField SaveFields::misc2Fields[];
+constexpr SaveStruct SaveFields::misc2Struct;
+constexpr SaveField SaveFields::misc3Fields[];
+constexpr SaveStruct SaveFields::misc3Struct;
+constexpr SaveField SaveFields::fieldFields[];
+constexpr SaveStruct SaveFields::fieldStruct;
+constexpr SaveField SaveFields::worldmapFields[];
+constexpr SaveStruct SaveFields::worldmapStruct;
+constexpr SaveField SaveFields::ttcardsFields[];
+constexpr SaveStruct SaveFields::ttcardsStruct;
+constexpr SaveField SaveFields::chocoboFields[];
+constexpr SaveStruct SaveFields::chocoboStruct;
+constexpr SaveField SaveFields::mainFields[];
+constexpr SaveStruct SaveFields::mainStruct;
+constexpr SaveField SaveFields::headerFields[];
+constexpr SaveStruct SaveFields::headerStruct;
+
+// No member is missing
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::gforcesStruct) == SaveFields::gforcesStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::personnagesStruct) == SaveFields::personnagesStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::shopStruct) == SaveFields::shopStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::configStruct) == SaveFields::configStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::misc1Struct) == SaveFields::misc1Struct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::limitbStruct) == SaveFields::limitbStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::itemsStruct) == SaveFields::itemsStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::misc2Struct) == SaveFields::misc2Struct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::misc3Struct) == SaveFields::misc3Struct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::fieldStruct) == SaveFields::fieldStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::worldmapStruct) == SaveFields::worldmapStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::ttcardsStruct) == SaveFields::ttcardsStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::chocoboStruct) == SaveFields::chocoboStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::mainStruct) == SaveFields::mainStruct.size);
+Q_STATIC_ASSERT(SaveFields::fieldsSize(SaveFields::headerStruct) == SaveFields::headerStruct.size);
+
+/*
+ * Innermost field containing offset, nullptr if offset is out of s.
+ */
+const SaveField *SaveFields::fieldAt(const SaveStruct &s, int offset)
+{
+	for(int i = 0 ; i < s.count ; ++i) {
+		const SaveField &f = s.fields[i];
+		if(offset >= f.offset && offset < f.offset + f.size) {
+			if(f.type == SaveField::Struct) {
+				const SaveField *sub = fieldAt(*f.fields, (offset - f.offset) % f.elementSize());
+				return sub ? sub : &f;
+			}
+			return &f;
+		}
+	}
+
+	return nullptr;
+}
+
+/*
+ * Path of the byte at offset in s, with the array indexes and the
+ * position of the byte in the element: "persos[2].magies[5]+1".
+ */
+QString SaveFields::path(const SaveStruct &s, int offset)
+{
+	for(int i = 0 ; i < s.count ; ++i) {
+		const SaveField &f = s.fields[i];
+		if(offset < f.offset || offset >= f.offset + f.size) {
+			continue;
+		}
+
+		const int index = (offset - f.offset) / f.elementSize(),
+		        elementOffset = (offset - f.offset) % f.elementSize();
+		QString ret = f.name;
+		if(f.count > 1) {
+			ret.append(QString("[%1]").arg(index));
+		}
+		if(f.type == SaveField::Struct) {
+			ret.append('.').append(path(*f.fields, elementOffset));
+		} else if(elementOffset > 0) {
+			ret.append(QString("+%1").arg(elementOffset));
+		}
+		return ret;
+	}
+
+	return QString("+%1").arg(offset);
+}
@@ -0,0 +1,456 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef SAVEFIELDS_H
+#define SAVEFIELDS_H
+
+#include <QtCore>
+#include <cstddef>
+#include <type_traits>
+#include "SaveData.h"
+
+struct SaveStruct;
+
+struct SaveField
+{
+	enum Type {
+		UInt8, Int8, UInt16, Int16, UInt32, Int32, Struct
+	};
+
+	const char *name;
+	quint16 offset; // In the parent struct
+	quint16 size; // All the elements
+	quint16 count; // Array extent, 1 if it is not an array
+	Type type;
+	const SaveStruct *fields; // Members of a Struct element
+
+	constexpr quint16 elementSize() const {
+		return size / count;
+	}
+};
+
+struct SaveStruct
+{
+	const char *name;
+	quint16 size;
+	const SaveField *fields;
+	int count;
+};
+
+template<typename T> constexpr SaveField::Type saveFieldType() { return SaveField::Struct; }
+template<> constexpr SaveField::Type saveFieldType<quint8>() { return SaveField::UInt8; }
+template<> constexpr SaveField::Type saveFieldType<qint8>() { return SaveField::Int8; }
+template<> constexpr SaveField::Type saveFieldType<quint16>() { return SaveField::UInt16; }
+template<> constexpr SaveField::Type saveFieldType<qint16>() { return SaveField::Int16; }
+template<> constexpr SaveField::Type saveFieldType<quint32>() { return SaveField::UInt32; }
+template<> constexpr SaveField::Type saveFieldType<qint32>() { return SaveField::Int32; }
+
+#define SAVE_FIELD_ELEMENT(S, m) \
+	std::remove_all_extents<decltype(S::m)>::type
+
+#define SAVE_FIELD(S, m) \
+	{ #m, quint16(offsetof(S, m)), quint16(sizeof(S::m)), \
+	  quint16(sizeof(S::m) / sizeof(SAVE_FIELD_ELEMENT(S, m))), \
+	  saveFieldType<SAVE_FIELD_ELEMENT(S, m)>(), nullptr }
+
+#define SAVE_STRUCT_FIELD(S, m, fieldStruct) \
+	{ #m, quint16(offsetof(S, m)), quint16(sizeof(S::m)), \
+	  quint16(sizeof(S::m) / sizeof(SAVE_FIELD_ELEMENT(S, m))), \
+	  SaveField::Struct, &fieldStruct }
+
+#define SAVE_STRUCT(S, fields) \
+	{ #S, quint16(sizeof(S)), fields, int(sizeof(fields) / sizeof(SaveField)) }
+
+/*
+ * Layout of MAIN, HEADER and their members, in the order of the
+ * structs of SaveData.h. Paths are member names separated by dots,
+ * like "misc2.game_time", offsets are relative to the struct.
+ */
+class SaveFields
+{
+public:
+	static constexpr SaveField gforcesFields[] = {
+		SAVE_FIELD(GFORCES, name),
+		SAVE_FIELD(GFORCES, exp),
+		SAVE_FIELD(GFORCES, u1),
+		SAVE_FIELD(GFORCES, exists),
+		SAVE_FIELD(GFORCES, HPs),
+		SAVE_FIELD(GFORCES, completeAbilities),
+		SAVE_FIELD(GFORCES, APs),
+		SAVE_FIELD(GFORCES, kills),
+		SAVE_FIELD(GFORCES, KOs),
+		SAVE_FIELD(GFORCES, learning),
+		SAVE_FIELD(GFORCES, forgotten1),
+		SAVE_FIELD(GFORCES, forgotten2),
+		SAVE_FIELD(GFORCES, forgotten3)
+	};
+	static constexpr SaveStruct gforcesStruct = SAVE_STRUCT(GFORCES, gforcesFields);
+
+	static constexpr SaveField personnagesFields[] = {
+		SAVE_FIELD(PERSONNAGES, current_HPs),
+		SAVE_FIELD(PERSONNAGES, HPs),
+		SAVE_FIELD(PERSONNAGES, exp),
+		SAVE_FIELD(PERSONNAGES, ID),
+		SAVE_FIELD(PERSONNAGES, weaponID),
+		SAVE_FIELD(PERSONNAGES, VGR),
+		SAVE_FIELD(PERSONNAGES, DFS),
+		SAVE_FIELD(PERSONNAGES, MGI),
+		SAVE_FIELD(PERSONNAGES, PSY),
+		SAVE_FIELD(PERSONNAGES, VTS),
+		SAVE_FIELD(PERSONNAGES, CHC),
+		SAVE_FIELD(PERSONNAGES, magies),
+		SAVE_FIELD(PERSONNAGES, commands),
+		SAVE_FIELD(PERSONNAGES, u1),
+		SAVE_FIELD(PERSONNAGES, abilities),
+		SAVE_FIELD(PERSONNAGES, gfs),
+		SAVE_FIELD(PERSONNAGES, u2),
+		SAVE_FIELD(PERSONNAGES, alternative_model),
+		SAVE_FIELD(PERSONNAGES, j_HP),
+		SAVE_FIELD(PERSONNAGES, j_VGR),
+		SAVE_FIELD(PERSONNAGES, j_DFS),
+		SAVE_FIELD(PERSONNAGES, j_MGI),
+		SAVE_FIELD(PERSONNAGES, j_PSY),
+		SAVE_FIELD(PERSONNAGES, j_VTS),
+		SAVE_FIELD(PERSONNAGES, j_ESQ),
+		SAVE_FIELD(PERSONNAGES, j_PRC),
+		SAVE_FIELD(PERSONNAGES, j_CHC),
+		SAVE_FIELD(PERSONNAGES, j_attEle),
+		SAVE_FIELD(PERSONNAGES, j_attMtl),
+		SAVE_FIELD(PERSONNAGES, j_defEle),
+		SAVE_FIELD(PERSONNAGES, j_defMtl),
+		SAVE_FIELD(PERSONNAGES, u3),
+		SAVE_FIELD(PERSONNAGES, compatibility),
+		SAVE_FIELD(PERSONNAGES, kills),
+		SAVE_FIELD(PERSONNAGES, KOs),
+		SAVE_FIELD(PERSONNAGES, exists),
+		SAVE_FIELD(PERSONNAGES, u4),
+		SAVE_FIELD(PERSONNAGES, status),
+		SAVE_FIELD(PERSONNAGES, u5)
+	};
+	static constexpr SaveStruct personnagesStruct = SAVE_STRUCT(PERSONNAGES, personnagesFields);
+
+	static constexpr SaveField shopFields[] = {
+		SAVE_FIELD(SHOP, items),
+		SAVE_FIELD(SHOP, visited),
+		SAVE_FIELD(SHOP, u1)
+	};
+	static constexpr SaveStruct shopStruct = SAVE_STRUCT(SHOP, shopFields);
+
+	static constexpr SaveField configFields[] = {
+		SAVE_FIELD(CONFIG, vts_combat),
+		SAVE_FIELD(CONFIG, vts_msg_combat),
+		SAVE_FIELD(CONFIG, vts_msg),
+		SAVE_FIELD(CONFIG, analog_volume),
+		SAVE_FIELD(CONFIG, divers),
+		SAVE_FIELD(CONFIG, scan),
+		SAVE_FIELD(CONFIG, camera),
+		SAVE_FIELD(CONFIG, u3),
+		SAVE_FIELD(CONFIG, L2),
+		SAVE_FIELD(CONFIG, R2),
+		SAVE_FIELD(CONFIG, L1),
+		SAVE_FIELD(CONFIG, R1),
+		SAVE_FIELD(CONFIG, TRIANGLE),
+		SAVE_FIELD(CONFIG, ROND),
+		SAVE_FIELD(CONFIG, CROIX),
+		SAVE_FIELD(CONFIG, CARRE),
+		SAVE_FIELD(CONFIG, SELECT),
+		SAVE_FIELD(CONFIG, u4),
+		SAVE_FIELD(CONFIG, u5),
+		SAVE_FIELD(CONFIG, START)
+	};
+	static constexpr SaveStruct configStruct = SAVE_STRUCT(CONFIG, configFields);
+
+	static constexpr SaveField misc1Fields[] = {
+		SAVE_FIELD(MISC1, party),
+		SAVE_FIELD(MISC1, unlocked_weapons),
+		SAVE_FIELD(MISC1, griever),
+		SAVE_FIELD(MISC1, u1),
+		SAVE_FIELD(MISC1, u2),
+		SAVE_FIELD(MISC1, gils),
+		SAVE_FIELD(MISC1, dream_gils)
+	};
+	static constexpr SaveStruct misc1Struct = SAVE_STRUCT(MISC1, misc1Fields);
+
+	static constexpr SaveField limitbFields[] = {
+		SAVE_FIELD(LIMITB, quistis),
+		SAVE_FIELD(LIMITB, zell),
+		SAVE_FIELD(LIMITB, irvine),
+		SAVE_FIELD(LIMITB, selphie),
+		SAVE_FIELD(LIMITB, angel_completed),
+		SAVE_FIELD(LIMITB, angel_known),
+		SAVE_FIELD(LIMITB, angel_pts)
+	};
+	static constexpr SaveStruct limitbStruct = SAVE_STRUCT(LIMITB, limitbFields);
+
+	static constexpr SaveField itemsFields[] = {
+		SAVE_FIELD(ITEMS, battle_order),
+		SAVE_FIELD(ITEMS, items)
+	};
+	static constexpr SaveStruct itemsStruct = SAVE_STRUCT(ITEMS, itemsFields);
+
+	static constexpr SaveField misc2Fields[] = {
+		SAVE_FIELD(MISC2, game_time),
+		SAVE_FIELD(MISC2, countdown),
+		SAVE_FIELD(MISC2, u1),
+		SAVE_FIELD(MISC2, victory_count),
+		SAVE_FIELD(MISC2, u2),
+		SAVE_FIELD(MISC2, battle_escaped),
+		SAVE_FIELD(MISC2, u3),
+		SAVE_FIELD(MISC2, tomberry_vaincus),
+		SAVE_FIELD(MISC2, tomberry_sr_vaincu),
+		SAVE_FIELD(MISC2, u4),
+		SAVE_FIELD(MISC2, elmidea_battle_r1),
+		SAVE_FIELD(MISC2, succube_battle_elemental),
+		SAVE_FIELD(MISC2, trex_battle_mental),
+		SAVE_FIELD(MISC2, battle_irvine),
+		SAVE_FIELD(MISC2, magic_drawn_once),
+		SAVE_FIELD(MISC2, ennemy_scanned_once),
+		SAVE_FIELD(MISC2, renzokuken_auto),
+		SAVE_FIELD(MISC2, renzokuken_indicator),
+		SAVE_FIELD(MISC2, dream),
+		SAVE_FIELD(MISC2, tutorial_infos),
+		SAVE_FIELD(MISC2, testLevel),
+		SAVE_FIELD(MISC2, u5),
+		SAVE_FIELD(MISC2, party),
+		SAVE_FIELD(MISC2, u6),
+		SAVE_FIELD(MISC2, module),
+		SAVE_FIELD(MISC2, location),
+		SAVE_FIELD(MISC2, location_last),
+		SAVE_FIELD(MISC2, x),
+		SAVE_FIELD(MISC2, y),
+		SAVE_FIELD(MISC2, id),
+		SAVE_FIELD(MISC2, dir),
+		SAVE_FIELD(MISC2, u7)
+	};
+	static constexpr SaveStruct misc2Struct = SAVE_STRUCT(MISC2, misc2Fields);
+
+	static constexpr SaveField misc3Fields[] = {
+		SAVE_FIELD(MISC3, u1),
+		SAVE_FIELD(MISC3, steps),
+		SAVE_FIELD(MISC3, payslip),
+		SAVE_FIELD(MISC3, u2),
+		SAVE_FIELD(MISC3, seedExp),
+		SAVE_FIELD(MISC3, u3),
+		SAVE_FIELD(MISC3, victory_count),
+		SAVE_FIELD(MISC3, u4),
+		SAVE_FIELD(MISC3, battle_escaped),
+		SAVE_FIELD(MISC3, kills),
+		SAVE_FIELD(MISC3, ko),
+		SAVE_FIELD(MISC3, u5),
+		SAVE_FIELD(MISC3, monster_kills),
+		SAVE_FIELD(MISC3, gils),
+		SAVE_FIELD(MISC3, dream_gils),
+		SAVE_FIELD(MISC3, current_frame),
+		SAVE_FIELD(MISC3, last_field_id),
+		SAVE_FIELD(MISC3, current_car_rent),
+		SAVE_FIELD(MISC3, music_util),
+		SAVE_FIELD(MISC3, move_find_ondine),
+		SAVE_FIELD(MISC3, u6),
+		SAVE_FIELD(MISC3, u7),
+		SAVE_FIELD(MISC3, music_related),
+		SAVE_FIELD(MISC3, u8),
+		SAVE_FIELD(MISC3, draw_points),
+		SAVE_FIELD(MISC3, steps2),
+		SAVE_FIELD(MISC3, battle_mode),
+		SAVE_FIELD(MISC3, u9),
+		SAVE_FIELD(MISC3, uA),
+		SAVE_FIELD(MISC3, music_volume),
+		SAVE_FIELD(MISC3, uB),
+		SAVE_FIELD(MISC3, music_played),
+		SAVE_FIELD(MISC3, uC),
+		SAVE_FIELD(MISC3, music_is_played),
+		SAVE_FIELD(MISC3, uD),
+		SAVE_FIELD(MISC3, battle_music),
+		SAVE_FIELD(MISC3, disc),
+		SAVE_FIELD(MISC3, uE),
+		SAVE_FIELD(MISC3, music_is_loaded),
+		SAVE_FIELD(MISC3, battle_off),
+		SAVE_FIELD(MISC3, uF),
+		SAVE_FIELD(MISC3, save_enabled),
+		SAVE_FIELD(MISC3, uG),
+		SAVE_FIELD(MISC3, music_loaded),
+		SAVE_FIELD(MISC3, uH)
+	};
+	static constexpr SaveStruct misc3Struct = SAVE_STRUCT(MISC3, misc3Fields);
+
+	static constexpr SaveField fieldFields[] = {
+		SAVE_FIELD(FIELD, game_moment),
+		SAVE_FIELD(FIELD, ward_unused),
+		SAVE_FIELD(FIELD, unused1),
+		SAVE_FIELD(FIELD, save_flag),
+		SAVE_FIELD(FIELD, unused2),
+		SAVE_FIELD(FIELD, wm_related),
+		SAVE_FIELD(FIELD, unused3),
+		SAVE_FIELD(FIELD, tt_rules),
+		SAVE_FIELD(FIELD, tt_traderules),
+		SAVE_FIELD(FIELD, tt_lastrules),
+		SAVE_FIELD(FIELD, tt_lastregion),
+		SAVE_FIELD(FIELD, tt_new_rules_tmp),
+		SAVE_FIELD(FIELD, tt_new_trade_rules_tmp),
+		SAVE_FIELD(FIELD, tt_add_this_rule_queen_tmp),
+		SAVE_FIELD(FIELD, tt_cardqueen_location),
+		SAVE_FIELD(FIELD, tt_traderating_region),
+		SAVE_FIELD(FIELD, tt_traderating),
+		SAVE_FIELD(FIELD, tt_degeneration),
+		SAVE_FIELD(FIELD, tt_curtraderulequeen),
+		SAVE_FIELD(FIELD, tt_cardqueen_quest),
+		SAVE_FIELD(FIELD, unused4),
+		SAVE_FIELD(FIELD, timber_maniacs),
+		SAVE_FIELD(FIELD, u1),
+		SAVE_FIELD(FIELD, tt_players_bgu_dialogs1),
+		SAVE_FIELD(FIELD, tt_players_bgu_dialogs2),
+		SAVE_FIELD(FIELD, tt_players_bgu_dialogs3),
+		SAVE_FIELD(FIELD, tt_cc_quest),
+		SAVE_FIELD(FIELD, tt_bgu_victory_count),
+		SAVE_FIELD(FIELD, u2)
+	};
+	static constexpr SaveStruct fieldStruct = SAVE_STRUCT(FIELD, fieldFields);
+
+	static constexpr SaveField worldmapFields[] = {
+		SAVE_FIELD(WORLDMAP, char_pos),
+		SAVE_FIELD(WORLDMAP, uknown_pos1),
+		SAVE_FIELD(WORLDMAP, ragnarok_pos),
+		SAVE_FIELD(WORLDMAP, bgu_pos),
+		SAVE_FIELD(WORLDMAP, car_pos),
+		SAVE_FIELD(WORLDMAP, uknown_pos2),
+		SAVE_FIELD(WORLDMAP, uknown_pos3),
+		SAVE_FIELD(WORLDMAP, uknown_pos4),
+		SAVE_FIELD(WORLDMAP, steps_related),
+		SAVE_FIELD(WORLDMAP, car_rent),
+		SAVE_FIELD(WORLDMAP, u1),
+		SAVE_FIELD(WORLDMAP, u2),
+		SAVE_FIELD(WORLDMAP, u3),
+		SAVE_FIELD(WORLDMAP, disp_map_config),
+		SAVE_FIELD(WORLDMAP, u4),
+		SAVE_FIELD(WORLDMAP, car_steps_related),
+		SAVE_FIELD(WORLDMAP, car_steps_related2),
+		SAVE_FIELD(WORLDMAP, vehicles_instructions_worldmap),
+		SAVE_FIELD(WORLDMAP, koyok_quest),
+		SAVE_FIELD(WORLDMAP, obel_quest),
+		SAVE_FIELD(WORLDMAP, u6)
+	};
+	static constexpr SaveStruct worldmapStruct = SAVE_STRUCT(WORLDMAP, worldmapFields);
+
+	static constexpr SaveField ttcardsFields[] = {
+		SAVE_FIELD(TTCARDS, cards),
+		SAVE_FIELD(TTCARDS, card_locations),
+		SAVE_FIELD(TTCARDS, cards_rare),
+		SAVE_FIELD(TTCARDS, u1),
+		SAVE_FIELD(TTCARDS, tt_victory_count),
+		SAVE_FIELD(TTCARDS, tt_defeat_count),
+		SAVE_FIELD(TTCARDS, tt_egality_count),
+		SAVE_FIELD(TTCARDS, u2),
+		SAVE_FIELD(TTCARDS, u3)
+	};
+	static constexpr SaveStruct ttcardsStruct = SAVE_STRUCT(TTCARDS, ttcardsFields);
+
+	static constexpr SaveField chocoboFields[] = {
+		SAVE_FIELD(CHOCOBO, enabled),
+		SAVE_FIELD(CHOCOBO, level),
+		SAVE_FIELD(CHOCOBO, current_hp),
+		SAVE_FIELD(CHOCOBO, max_hp),
+		SAVE_FIELD(CHOCOBO, weapon),
+		SAVE_FIELD(CHOCOBO, rank),
+		SAVE_FIELD(CHOCOBO, move),
+		SAVE_FIELD(CHOCOBO, saveCount),
+		SAVE_FIELD(CHOCOBO, id_related),
+		SAVE_FIELD(CHOCOBO, u1),
+		SAVE_FIELD(CHOCOBO, itemClassACount),
+		SAVE_FIELD(CHOCOBO, itemClassBCount),
+		SAVE_FIELD(CHOCOBO, itemClassCCount),
+		SAVE_FIELD(CHOCOBO, itemClassDCount),
+		SAVE_FIELD(CHOCOBO, u2),
+		SAVE_FIELD(CHOCOBO, associatedSaveID),
+		SAVE_FIELD(CHOCOBO, u3),
+		SAVE_FIELD(CHOCOBO, boko_attack),
+		SAVE_FIELD(CHOCOBO, u4),
+		SAVE_FIELD(CHOCOBO, home_walking),
+		SAVE_FIELD(CHOCOBO, u5)
+	};
+	static constexpr SaveStruct chocoboStruct = SAVE_STRUCT(CHOCOBO, chocoboFields);
+
+	static constexpr SaveField mainFields[] = {
+		SAVE_STRUCT_FIELD(MAIN, gfs, gforcesStruct),
+		SAVE_STRUCT_FIELD(MAIN, persos, personnagesStruct),
+		SAVE_STRUCT_FIELD(MAIN, shops, shopStruct),
+		SAVE_STRUCT_FIELD(MAIN, config, configStruct),
+		SAVE_STRUCT_FIELD(MAIN, misc1, misc1Struct),
+		SAVE_STRUCT_FIELD(MAIN, limitb, limitbStruct),
+		SAVE_STRUCT_FIELD(MAIN, items, itemsStruct),
+		SAVE_STRUCT_FIELD(MAIN, misc2, misc2Struct),
+		SAVE_STRUCT_FIELD(MAIN, misc3, misc3Struct),
+		SAVE_STRUCT_FIELD(MAIN, field, fieldStruct),
+		SAVE_STRUCT_FIELD(MAIN, worldmap, worldmapStruct),
+		SAVE_STRUCT_FIELD(MAIN, ttcards, ttcardsStruct),
+		SAVE_STRUCT_FIELD(MAIN, chocobo, chocoboStruct)
+	};
+	static constexpr SaveStruct mainStruct = SAVE_STRUCT(MAIN, mainFields);
+
+	static constexpr SaveField headerFields[] = {
+		SAVE_FIELD(HEADER, locationID),
+		SAVE_FIELD(HEADER, hpLeader),
+		SAVE_FIELD(HEADER, hpMaxLeader),
+		SAVE_FIELD(HEADER, saveCount),
+		SAVE_FIELD(HEADER, gils),
+		SAVE_FIELD(HEADER, time),
+		SAVE_FIELD(HEADER, nivLeader),
+		SAVE_FIELD(HEADER, party),
+		SAVE_FIELD(HEADER, squall),
+		SAVE_FIELD(HEADER, rinoa),
+		SAVE_FIELD(HEADER, angelo),
+		SAVE_FIELD(HEADER, boko),
+		SAVE_FIELD(HEADER, disc),
+		SAVE_FIELD(HEADER, curSave)
+	};
+	static constexpr SaveStruct headerStruct = SAVE_STRUCT(HEADER, headerFields);
+
+	// Compile-time lookups, an unknown path does not compile
+	static constexpr const SaveField &field(const SaveStruct &s, const char *path) {
+		return path[nameLength(path)] == '\0'
+		        ? s.fields[indexOf(s, path, nameLength(path))]
+		        : field(*s.fields[indexOf(s, path, nameLength(path))].fields,
+		                path + nameLength(path) + 1);
+	}
+	static constexpr int offset(const SaveStruct &s, const char *path) {
+		return s.fields[indexOf(s, path, nameLength(path))].offset
+		        + (path[nameLength(path)] == '\0'
+		           ? 0
+		           : offset(*s.fields[indexOf(s, path, nameLength(path))].fields,
+		                    path + nameLength(path) + 1));
+	}
+	// Sum of the field sizes, equals to s.size when no member is missing
+	static constexpr int fieldsSize(const SaveStruct &s, int i = 0) {
+		return i >= s.count ? 0 : s.fields[i].size + fieldsSize(s, i + 1);
+	}
+
+	static const SaveField *fieldAt(const SaveStruct &s, int offset);
+	static QString path(const SaveStruct &s, int offset);
+private:
+	static constexpr int nameLength(const char *path, int i = 0) {
+		return path[i] == '\0' || path[i] == '.' ? i : nameLength(path, i + 1);
+	}
+	static constexpr bool isName(const char *name, const char *path, int length) {
+		return length == 0 ? *name == '\0' : *name == *path && isName(name + 1, path + 1, length - 1);
+	}
+	static constexpr int indexOf(const SaveStruct &s, const char *path, int length, int i = 0) {
+		return i >= s.count
+		        ? throw "Unknown save field"
+		        : isName(s.fields[i].name, path, length) ? i : indexOf(s, path, length, i + 1);
+	}
+};
+
+#endif // SAVEFIELDS_H
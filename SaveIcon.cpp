@@ -18,46 +18,17 @@
 
 #include "SaveIcon.h"
 
-SaveIconData::SaveIconData() :
-	_nbFrames(0)
-{
-}
-
-SaveIconData::SaveIconData(const QByteArray &data, quint8 nbFrames) :
-	_data(data), _nbFrames(nbFrames)
-{
-}
-
-void SaveIconData::setData(const QByteArray &data)
-{
-	_data = data;
-}
-
-void SaveIconData::setNbFrames(quint8 nbFrames)
-{
-	_nbFrames = nbFrames;
-}
-
-const QByteArray &SaveIconData::data() const
-{
-	return _data;
-}
-
-quint8 SaveIconData::nbFrames() const
-{
-	return _nbFrames;
-}
-
-QPixmap SaveIconData::icon(int curFrame, bool showCW) const
+QPixmap SaveIcon::icon(const SaveIconData &saveIconData, int curFrame, bool showCW)
 {
+	const QByteArray &data = saveIconData.data();
 	quint16 i;
 
-	if(_data.isEmpty())	return QPixmap();
+	if(data.isEmpty())	return QPixmap();
 
 	if(!showCW)
 	{
 		//palette
-		const char *access_data = _data.constData();
+		const char *access_data = data.constData();
 		QVector<QRgb> colors;
 		quint16 color;
 		for(i=0 ; i<16 ; ++i)
@@ -73,11 +44,11 @@ QPixmap SaveIconData::icon(int curFrame, bool showCW) const
 
 		image.setColorTable(colors);
 
-		if(_data.size() < lastPos)	return QPixmap();
+		if(data.size() < lastPos)	return QPixmap();
 
 		for(i=firstPos ; i<lastPos ; ++i)
 		{
-			quint8 index = _data.at(i);
+			quint8 index = data.at(i);
 			pixels[curPx++] = index & 0xF;
 			pixels[curPx++] = index >> 4;
 		}
@@ -85,7 +56,7 @@ QPixmap SaveIconData::icon(int curFrame, bool showCW) const
 		return QPixmap::fromImage(image);
 	}
 
-	if(_data.size() != 288)	return QPixmap();
+	if(data.size() != 288)	return QPixmap();
 
 	QImage image(32, 32, QImage::Format_MonoLSB);
 	uchar *pixels = image.bits();
@@ -93,7 +64,7 @@ QPixmap SaveIconData::icon(int curFrame, bool showCW) const
 
 	for(i=160 ; i<288 ; ++i)
 	{
-		pixels[curPx++] = ~_data.at(i);
+		pixels[curPx++] = ~data.at(i);
 	}
 
 	return QPixmap::fromImage(image);
@@ -162,5 +133,5 @@ void SaveIcon::nextFrame()
 
 QPixmap SaveIcon::pixmap() const
 {
-	return _data.icon(_curFrame, _showCW);
+	return icon(_data, _curFrame, _showCW);
 }
@@ -20,23 +20,9 @@
 #define DEF_SAVEICON
 
 #include <QtGui>
+#include "SaveIconData.h"
 #define COEFF_COLOR	8.2258064516129032258064516129032 // 255/31
 
-class SaveIconData
-{
-public:
-	SaveIconData();
-	explicit SaveIconData(const QByteArray &data, quint8 nbFrames=1);
-	void setData(const QByteArray &data);
-	void setNbFrames(quint8 nbFrames);
-	const QByteArray &data() const;
-	quint8 nbFrames() const;
-	QPixmap icon(int curFrame=0, bool showCW=false) const;
-private:
-	QByteArray _data;
-	quint8 _nbFrames;
-};
-
 struct SaveIconTimer : public QTimer
 {
 	explicit SaveIconTimer(QObject *parent=0) :
@@ -58,6 +44,7 @@ public:
 	quint8 curFrame() const;
 	bool CWIsVisible() const;
 	QPixmap pixmap() const;
+	static QPixmap icon(const SaveIconData &data, int curFrame=0, bool showCW=false);
 	static SaveIconTimer timer;
 signals:
 	void nextIcon(const QPixmap &);
@@ -0,0 +1,49 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+#include "SaveIconData.h"
+
+SaveIconData::SaveIconData() :
+	_nbFrames(0)
+{
+}
+
+SaveIconData::SaveIconData(const QByteArray &data, quint8 nbFrames) :
+	_data(data), _nbFrames(nbFrames)
+{
+}
+
+void SaveIconData::setData(const QByteArray &data)
+{
+	_data = data;
+}
+
+void SaveIconData::setNbFrames(quint8 nbFrames)
+{
+	_nbFrames = nbFrames;
+}
+
+const QByteArray &SaveIconData::data() const
+{
+	return _data;
+}
+
+quint8 SaveIconData::nbFrames() const
+{
+	return _nbFrames;
+}
@@ -0,0 +1,37 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef DEF_SAVEICONDATA
+#define DEF_SAVEICONDATA
+
+#include <QtCore>
+
+class SaveIconData
+{
+public:
+	SaveIconData();
+	explicit SaveIconData(const QByteArray &data, quint8 nbFrames=1);
+	void setData(const QByteArray &data);
+	void setNbFrames(quint8 nbFrames);
+	const QByteArray &data() const;
+	quint8 nbFrames() const;
+private:
+	QByteArray _data;
+	quint8 _nbFrames;
+};
+
+#endif
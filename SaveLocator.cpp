@@ -0,0 +1,243 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#include "SaveLocator.h"
+#include "SaveData.h"
+#include "SaveFields.h"
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAVELOCATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+qint64 SaveLocator::indexOf(const QByteArray &data, const QByteArray &needle, qint64 from)
+{
+	const int n = needle.size();
+	if(n == 0 || from < 0 || data.size() - from < n) {
+		return -1;
+	}
+
+	const char *begin = data.constData(), *p = begin + from,
+	        *last = begin + data.size() - n, // Last possible match
+	        *pattern = needle.constData();
+
+#ifdef SAVELOCATOR_SSE2
+	// Compares the first and the last byte of the needle at 16 positions at once,
+	// only the positions where both match are compared entirely
+	const __m128i first = _mm_set1_epi8(pattern[0]),
+	        lastByte = _mm_set1_epi8(pattern[n - 1]);
+
+	while(last - p >= 15) {
+		const __m128i blockFirst = _mm_loadu_si128((const __m128i *)p),
+		        blockLast = _mm_loadu_si128((const __m128i *)(p + n - 1));
+		quint32 mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+		                                               _mm_cmpeq_epi8(blockLast, lastByte)));
+		while(mask) {
+			const int i = qCountTrailingZeroBits(mask);
+			if(memcmp(p + i, pattern, n) == 0) {
+				return p + i - begin;
+			}
+			mask &= mask - 1;
+		}
+		p += 16;
+	}
+#endif
+
+	while(p <= last) {
+		p = (const char *)memchr(p, pattern[0], last - p + 1);
+		if(!p) {
+			break;
+		}
+		if(memcmp(p, pattern, n) == 0) {
+			return p - begin;
+		}
+		++p;
+	}
+
+	return -1;
+}
+
+void SaveLocator::sort(QList<Candidate> &candidates)
+{
+	// Stable: at equal confidence, the first in the RAM first
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+		return a.confidence > b.confidence;
+	});
+}
+
+/*
+ * The save is found by the "FF-8" constant of MISC3,
+ * then the confidence depends on the HEADER values.
+ */
+QList<SaveLocator::Candidate> SaveLocator::findSaves(const QByteArray &ram)
+{
+	constexpr qint64 ff8Offset = 2 + sizeof(HEADER) + SaveFields::offset(SaveFields::mainStruct, "misc3.u1");
+	const QByteArray ff8("FF-8", 4);
+	QList<Candidate> candidates;
+	qint64 pos = 0;
+
+	while((pos = indexOf(ram, ff8, pos)) >= 0) {
+		const qint64 offset = pos - ff8Offset;
+		if(offset >= 0 && offset + SSTATE_SAVE_SIZE <= ram.size()) {
+			candidates.append(Candidate(offset, saveConfidence(ram.constData() + offset),
+			                            ram.mid(offset, SSTATE_SAVE_SIZE)));
+		}
+		pos += ff8.size();
+	}
+
+	sort(candidates);
+
+	return candidates;
+}
+
+int SaveLocator::saveConfidence(const char *save)
+{
+	int confidence = 30; // "FF-8"
+	quint16 ff8;
+	HEADER header;
+
+	memcpy(&ff8, save, 2);
+	memcpy(&header, save + 2, sizeof(HEADER));
+
+	// PC Demo is 0xFF8
+	if(ff8 == 0x8FF || ff8 == 0xFF8) {
+		confidence += 20;
+	}
+	if(header.disc <= 3) {
+		confidence += 10;
+	}
+	if(header.nivLeader >= 1 && header.nivLeader <= 100) {
+		confidence += 10;
+	}
+	if(header.hpLeader <= header.hpMaxLeader && header.hpMaxLeader <= 9999) {
+		confidence += 10;
+	}
+	if((header.party[0] < 8 || header.party[0] == 0xFF)
+	        && (header.party[1] < 8 || header.party[1] == 0xFF)
+	        && (header.party[2] < 8 || header.party[2] == 0xFF)) {
+		confidence += 10;
+	}
+	if(header.gils <= 99999999) {
+		confidence += 5;
+	}
+	if(header.locationID < 251) {
+		confidence += 5;
+	}
+
+	return confidence;
+}
+
+/*
+ * Directory frame of the first block of a save:
+ * in use, 8192 bytes, no next block, then "B" + country.
+ */
+QList<SaveLocator::Candidate> SaveLocator::findMCHeaders(const QByteArray &ram)
+{
+	const QByteArray frame("\x51\x00\x00\x00\x00\x20\x00\x00\xFF\xFF\x42", 11);
+	QList<Candidate> candidates;
+	qint64 pos = 0;
+
+	while((pos = indexOf(ram, frame, pos)) >= 0) {
+		if(pos + SSTATE_MCHEADER_SIZE <= ram.size()) {
+			candidates.append(Candidate(pos, MCHeaderConfidence(ram.constData() + pos),
+			                            ram.mid(pos, SSTATE_MCHEADER_SIZE)));
+		}
+		pos += frame.size();
+	}
+
+	sort(candidates);
+
+	return candidates;
+}
+
+/*
+ * The window keeps the last SSTATE_SAVE_SIZE - 1 bytes of the previous
+ * chunk: a save or a header which crosses two chunks is found entirely
+ * in the next window, and one found in the previous window cannot fit
+ * in this tail, except headers, which are filtered by their end.
+ */
+void SaveLocator::scan(QIODevice *device, qint64 maxSize,
+                       QList<Candidate> &saves, QList<Candidate> &MCHeaders)
+{
+	const int tailSize = SSTATE_SAVE_SIZE - 1;
+	QByteArray window;
+	qint64 windowPos = 0, readSize = 0;
+
+	saves.clear();
+	MCHeaders.clear();
+
+	while(readSize < maxSize) {
+		const QByteArray chunk = device->read(qMin(qint64(SSTATE_CHUNK_SIZE), maxSize - readSize));
+		if(chunk.isEmpty()) {
+			break;
+		}
+		readSize += chunk.size();
+
+		// Candidates which end in the tail were found in the previous window
+		const int tail = window.size();
+		window.append(chunk);
+
+		for(Candidate candidate : findSaves(window)) {
+			if(candidate.offset + SSTATE_SAVE_SIZE > tail) {
+				candidate.offset += windowPos;
+				saves.append(candidate);
+			}
+		}
+		for(Candidate candidate : findMCHeaders(window)) {
+			if(candidate.offset + SSTATE_MCHEADER_SIZE > tail) {
+				candidate.offset += windowPos;
+				MCHeaders.append(candidate);
+			}
+		}
+
+		if(window.size() > tailSize) {
+			windowPos += window.size() - tailSize;
+			window = window.right(tailSize);
+		}
+	}
+
+	sort(saves);
+	sort(MCHeaders);
+}
+
+int SaveLocator::MCHeaderConfidence(const char *header)
+{
+	int confidence = 40; // Frame
+	const char country = header[11];
+
+	if(country == COUNTRY_JP || country == COUNTRY_US || country == COUNTRY_EU) {
+		confidence += 20;
+	}
+	// Product code, like "SLUS-00892" or "SLUSP00892"
+	if(header[12] == 'S' && header[13] == 'L'
+	        && (header[16] == '-' || header[16] == 'P')) {
+		confidence += 20;
+	}
+	// Printable identifier, like "FF0801"
+	bool printable = true;
+	for(int i = 22 ; i < 28 ; ++i) {
+		if(header[i] < 0x20 || header[i] > 0x7E) {
+			printable = false;
+			break;
+		}
+	}
+	if(printable) {
+		confidence += 20;
+	}
+
+	return confidence;
+}
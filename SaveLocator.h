@@ -0,0 +1,61 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef SAVELOCATOR_H
+#define SAVELOCATOR_H
+
+#include <QtCore>
+
+// Size of a save in the PlayStation RAM: 0x08FF, HEADER and MAIN
+#define SSTATE_SAVE_SIZE	0x139E
+// Size of a memory card directory frame copy in the RAM
+#define SSTATE_MCHEADER_SIZE	0x20
+// States are scanned up to this size
+#define SSTATE_MAX_SIZE	0x1000000
+// States are scanned by chunks of this size
+#define SSTATE_CHUNK_SIZE	0x100000
+
+/*
+ * Finds FF8 saves and memory card headers in the RAM dump of
+ * an emulator save state, by content instead of by offset.
+ */
+class SaveLocator
+{
+public:
+	struct Candidate {
+		Candidate(qint64 offset, int confidence, const QByteArray &data) :
+		    offset(offset), confidence(confidence), data(data) {}
+		qint64 offset;
+		int confidence; // 0-100
+		QByteArray data; // Copy of the save or of the header
+	};
+
+	// Sorted by confidence, highest first
+	static QList<Candidate> findSaves(const QByteArray &ram);
+	static QList<Candidate> findMCHeaders(const QByteArray &ram);
+	// Same, reading at most maxSize bytes of the device by chunks
+	static void scan(QIODevice *device, qint64 maxSize,
+	                 QList<Candidate> &saves, QList<Candidate> &MCHeaders);
+	// Like memmem, 16 bytes per iteration with SSE2
+	static qint64 indexOf(const QByteArray &data, const QByteArray &needle, qint64 from = 0);
+private:
+	static int saveConfidence(const char *save);
+	static int MCHeaderConfidence(const char *header);
+	static void sort(QList<Candidate> &candidates);
+};
+
+#endif // SAVELOCATOR_H
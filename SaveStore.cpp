@@ -0,0 +1,261 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#include "SaveStore.h"
+
+#define MANIFEST_MAGIC	"hyne-store 1"
+#define NO_BLOCK		"-"
+
+SaveStore::SaveStore(const QString &dirname) :
+	_dir(dirname)
+{
+}
+
+QByteArray SaveStore::hash(const QByteArray &data)
+{
+	return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+QString SaveStore::blockPath(const QByteArray &hash) const
+{
+	return _dir.filePath(QString("blocks/%1/%2")
+	                     .arg(QString(hash.left(2)), QString(hash.mid(2))));
+}
+
+QString SaveStore::cardPath(const QString &name) const
+{
+	return _dir.filePath(QString("cards/%1").arg(name));
+}
+
+bool SaveStore::contains(const QByteArray &data) const
+{
+	return QFile::exists(blockPath(hash(data)));
+}
+
+QStringList SaveStore::cards() const
+{
+	QDir cardsDir(_dir.filePath("cards"));
+	QStringList names;
+	QDirIterator it(cardsDir.path(), QDir::Files, QDirIterator::Subdirectories);
+
+	while(it.hasNext()) {
+		names.append(cardsDir.relativeFilePath(it.next()));
+	}
+	names.sort();
+
+	return names;
+}
+
+bool SaveStore::writeBlock(const QByteArray &data, QByteArray &hash)
+{
+	hash = SaveStore::hash(data);
+	const QString path = blockPath(hash);
+
+	// Already known: nothing to write
+	if(QFile::exists(path)) {
+		return true;
+	}
+
+	if(!QDir().mkpath(QFileInfo(path).path())) {
+		_errorString = QObject::tr("Impossible de créer le dossier %1.").arg(QFileInfo(path).path());
+		return false;
+	}
+
+	QSaveFile f(path);
+	if(!f.open(QIODevice::WriteOnly)
+	        || f.write(data) != data.size()
+	        || !f.commit()) {
+		_errorString = QObject::tr("Impossible d'écrire le fichier %1.\n%2").arg(path, f.errorString());
+		return false;
+	}
+
+	return true;
+}
+
+bool SaveStore::readBlock(const QByteArray &hash, QByteArray &data)
+{
+	QFile f(blockPath(hash));
+	if(!f.open(QIODevice::ReadOnly)) {
+		_errorString = QObject::tr("Bloc %1 introuvable.").arg(QString(hash));
+		return false;
+	}
+
+	data = f.readAll();
+
+	if(SaveStore::hash(data) != hash) {
+		_errorString = QObject::tr("Bloc %1 corrompu.").arg(QString(hash));
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Manifest: the magic, then one line per save: "<frame hash> <block hash>".
+ * The type of the imported card is not kept, it is chosen on export.
+ */
+bool SaveStore::importCard(SavecardData *savecard, const QString &name)
+{
+	_errorString.clear();
+
+	QByteArray manifest;
+	manifest.append(MANIFEST_MAGIC "\n");
+
+	for(SaveData *save : savecard->getSaves()) {
+		QByteArray frameHash(NO_BLOCK), blockHash;
+
+		if(save->hasMCHeader() && !writeBlock(save->saveMCHeader(), frameHash)) {
+			return false;
+		}
+		if(!writeBlock(save->save(), blockHash)) {
+			return false;
+		}
+
+		manifest.append(frameHash).append(' ').append(blockHash).append('\n');
+	}
+
+	const QString path = cardPath(name);
+
+	if(!QDir().mkpath(QFileInfo(path).path())) {
+		_errorString = QObject::tr("Impossible de créer le dossier %1.").arg(QFileInfo(path).path());
+		return false;
+	}
+
+	QSaveFile f(path);
+	if(!f.open(QIODevice::WriteOnly)
+	        || f.write(manifest) != manifest.size()
+	        || !f.commit()) {
+		_errorString = QObject::tr("Impossible d'écrire le fichier %1.\n%2").arg(path, f.errorString());
+		return false;
+	}
+
+	return true;
+}
+
+SavecardData *SaveStore::card(const QString &name)
+{
+	_errorString.clear();
+
+	QFile f(cardPath(name));
+	if(!f.open(QIODevice::ReadOnly)) {
+		_errorString = QObject::tr("Carte %1 introuvable.").arg(name);
+		return nullptr;
+	}
+
+	const QList<QByteArray> lines = f.readAll().split('\n');
+
+	if(lines.first() != MANIFEST_MAGIC) {
+		_errorString = QObject::tr("Carte %1 : format invalide.").arg(name);
+		return nullptr;
+	}
+
+	QList< QPair<QByteArray, QByteArray> > blocks;
+
+	for(int i = 1 ; i < lines.size() ; ++i) {
+		if(lines.at(i).isEmpty()) {
+			continue;
+		}
+		const QList<QByteArray> hashes = lines.at(i).split(' ');
+		if(hashes.size() != 2) {
+			_errorString = QObject::tr("Carte %1 : format invalide.").arg(name);
+			return nullptr;
+		}
+		QByteArray frame, block;
+		if((hashes.first() != NO_BLOCK && !readBlock(hashes.first(), frame))
+		        || !readBlock(hashes.last(), block)) {
+			return nullptr;
+		}
+		blocks.append(qMakePair(frame, block));
+	}
+
+	SavecardData *savecard = new SavecardData(blocks.size());
+
+	for(int i = 0 ; i < blocks.size() ; ++i) {
+		savecard->getSave(i)->open(blocks.at(i).second, blocks.at(i).first);
+	}
+
+	return savecard;
+}
+
+bool SaveStore::exportCard(const QString &name, const QString &path, SavecardData::Type type,
+                           const QByteArray &MCHeader, int slot)
+{
+	SavecardData *savecard = card(name);
+	if(!savecard) {
+		return false;
+	}
+
+	bool ok = true;
+
+	if(SavecardData::isOne(type)) {
+		// The given slot, or the only save of the card
+		const SaveData *save = nullptr;
+		for(SaveData *s : savecard->getSaves()) {
+			if(slot >= 0 ? s->id() == slot : !s->isDelete()) {
+				if(save) {
+					save = nullptr;
+					break;
+				}
+				if(type == SavecardData::Psv && !s->hasMCHeader()) {
+					s->setMCHeader(MCHeader);
+				}
+				save = s;
+			}
+		}
+		if(!save) {
+			_errorString = QObject::tr("Carte %1 : précisez la sauvegarde à exporter.").arg(name);
+			ok = false;
+		} else {
+			ok = savecard->saveOne(save, path, type);
+		}
+	} else if(type == SavecardData::PcSlot) {
+		// One file per save in the directory path, named like in the first slot of FF8 Steam
+		const QString filePattern = FF8Installation(FF8Installation::Steam).saveNamePattern(1);
+
+		if(!QDir().mkpath(path)) {
+			_errorString = QObject::tr("Impossible de créer le dossier %1.").arg(path);
+			ok = false;
+		} else {
+			for(const SaveData *save : savecard->getSaves()) {
+				if(!save->isDelete()) {
+					QString fileName = filePattern;
+					fileName.replace("{num}", QString("%1").arg(save->id() + 1, 2, 10, QChar('0')));
+					ok = savecard->saveOne(save, QDir(path).filePath(fileName), SavecardData::Pc) && ok;
+				}
+			}
+		}
+	} else {
+		// The directory frames are kept, if any
+		QList<int> ids;
+		bool hasFrames = true;
+		for(const SaveData *save : savecard->getSaves()) {
+			if(ids.size() < 15 && (save->hasMCHeader() || !save->isDelete())) {
+				ids.append(save->id());
+				hasFrames = hasFrames && save->hasMCHeader();
+			}
+		}
+		ok = savecard->save2PS(ids, path, type, hasFrames ? QByteArray() : MCHeader);
+	}
+
+	if(!ok && _errorString.isEmpty()) {
+		_errorString = savecard->errorString();
+	}
+
+	delete savecard;
+
+	return ok;
+}
@@ -0,0 +1,56 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef SAVESTORE_H
+#define SAVESTORE_H
+
+#include <QtCore>
+#include "SavecardData.h"
+
+/*
+ * Deduplicating store of saves, in a directory:
+ *  - blocks/xx/yyy...: each save block and MC directory frame,
+ *    named by the SHA-1 of its content, written once
+ *  - cards/<name>: manifest of a card, the list of its blocks
+ */
+class SaveStore
+{
+public:
+	explicit SaveStore(const QString &dirname);
+	bool importCard(SavecardData *savecard, const QString &name);
+	// The caller owns the returned card, nullptr on error
+	SavecardData *card(const QString &name);
+	// MCHeader is used when the saves have no directory frame (PC saves)
+	bool exportCard(const QString &name, const QString &path, SavecardData::Type type,
+	                const QByteArray &MCHeader = QByteArray(), int slot = -1);
+	bool contains(const QByteArray &data) const;
+	QStringList cards() const;
+	inline const QString &errorString() const {
+		return _errorString;
+	}
+	static QByteArray hash(const QByteArray &data);
+private:
+	bool writeBlock(const QByteArray &data, QByteArray &hash);
+	bool readBlock(const QByteArray &hash, QByteArray &data);
+	QString blockPath(const QByteArray &hash) const;
+	QString cardPath(const QString &name) const;
+
+	QDir _dir;
+	QString _errorString;
+};
+
+#endif // SAVESTORE_H
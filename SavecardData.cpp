@@ -17,19 +17,40 @@
  ****************************************************************************/
 
 #include "SavecardData.h"
+#include <QtConcurrent>
 #include "GZIP.h"
+#include "GZIPDevice.h"
 #include "Parameters.h"
-#include "LZS.h"
+#include "LZSDevice.h"
 #include "CryptographicHash.h"
+#include "SaveLocator.h"
+#include "SaveFields.h"
+#include <cstdio>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/uio.h>
+#include <climits>
+#include <cerrno>
+#ifndef IOV_MAX
+#define IOV_MAX 16 // _XOPEN_IOV_MAX
+#endif
+#endif
 
-SavecardData::SavecardData(const QString &path, quint8 slot, const FF8Installation &ff8Installation) :
-	_ok(true), start(0), _isModified(false), _slot(slot), _ff8Installation(ff8Installation)
+SavecardData::SavecardData(const QString &path, quint8 slot, const FF8Installation &ff8Installation,
+                           OpenOptions openOptions) :
+	_ok(true), start(0), _isModified(false), _slot(slot), _switchSaveSize(0), _ff8Installation(ff8Installation),
+	_openOptions(openOptions), _mappedFile(nullptr), _progress(nullptr),
+	_syncPolicy(SyncEachFile), _currentSnapshot(-1)
 {
 	open(path, slot);
 }
 
 SavecardData::SavecardData(int saveCount) :
-	_ok(true), start(0), _isModified(false)
+	_ok(true), start(0), _isModified(false), _slot(0), _switchSaveSize(0), _openOptions(NoOption), _mappedFile(nullptr),
+	_progress(nullptr), _syncPolicy(SyncEachFile), _currentSnapshot(-1)
 {
 	for(int i=0 ; i<saveCount ; ++i) {
 		addSave();
@@ -38,9 +59,17 @@ SavecardData::SavecardData(int saveCount) :
 	setType(Undefined);
 }
 
+SavecardData::SavecardData(quint8 slot, const FF8Installation &ff8Installation, OpenOptions openOptions) :
+	_ok(false), start(0), _isModified(false), _slot(slot), _switchSaveSize(0), _ff8Installation(ff8Installation),
+	_openOptions(openOptions), _mappedFile(nullptr), _progress(nullptr),
+	_syncPolicy(SyncEachFile), _currentSnapshot(-1)
+{
+}
+
 SavecardData::~SavecardData()
 {
 	for(SaveData *save : qAsConst(saves))	delete save;
+	delete _mappedFile;
 }
 
 bool SavecardData::open(const QString &path, quint8 slot)
@@ -56,63 +85,73 @@ bool SavecardData::open(const QString &path, quint8 slot)
 	else
 	{
 		setPath(QDir::fromNativeSeparators(QDir::cleanPath(path)));
-		QString extension = this->extension();
+		_ok = openFromContent();
+	}
 
-		if(extension.isEmpty() || extension == "ff8")
-		{
-			setType(Pc);
-			_ok = pc();
-		}
-		else if(extension == "mcr" || extension == "ddf" || extension == "mc"
-		   || extension == "mcd"|| extension == "mci" || extension == "ps"
-		   || extension == "psm" || extension == "vm1" || extension =="srm")
-		{
-			setType(Ps);
-			_ok = ps();
-		}
-		else if(extension == "mem" || extension == "vgs")
-		{
-			setType(Vgs);
-			_ok = ps();
-		}
-		else if(extension == "gme")
-		{
-			setType(Gme);
-			_ok = ps();
-		}
-		else if(extension == "vmp")
-		{
-			setType(Vmp);
-			_ok = ps();
-		}
-		else if(extension == "psv")
-		{
-			setType(Psv);
-			_ok = ps3();
-			if(!_ok) {
-				_ok = sstate_pSX();
-				setType(Undefined);
-			}
-		}
-		else if(extension == "000"
-				|| extension == "001"
-				|| extension == "002"
-				|| extension == "003"
-				|| extension == "004")
-		{
-			_ok = sstate_ePSXe();
-			setType(Undefined);
+	// compare(2, 3);
+
+	return _ok;
+}
+
+class SavecardDataOpener : public QRunnable
+{
+public:
+	SavecardDataOpener(const QString &path, quint8 slot, const FF8Installation &ff8Installation,
+	                   SavecardData::OpenOptions openOptions) :
+		_path(path), _slot(slot), _ff8Installation(ff8Installation), _openOptions(openOptions) {
+		_interface.reportStarted();
+	}
+	virtual ~SavecardDataOpener() {}
+	inline QFuture<SavecardData *> future() {
+		return _interface.future();
+	}
+	virtual void run();
+private:
+	QFutureInterface<SavecardData *> _interface;
+	QString _path;
+	quint8 _slot;
+	FF8Installation _ff8Installation;
+	SavecardData::OpenOptions _openOptions;
+};
+
+void SavecardDataOpener::run()
+{
+	if(!_interface.isCanceled()) {
+		SavecardData *savecard = new SavecardData(_slot, _ff8Installation, _openOptions);
+		savecard->_progress = &_interface;
+		savecard->open(_path, _slot);
+		savecard->_progress = nullptr;
+#ifndef Q_OS_WINRT
+		// The watcher is used by the thread of the application
+		if(QCoreApplication::instance()) {
+			savecard->fileWatcher.moveToThread(QCoreApplication::instance()->thread());
 		}
-		else
-		{
-			_ok = false;
-			setType(Unknown);
+#endif
+
+		if(_interface.isCanceled()) {
+			delete savecard;
+		} else {
+			_interface.reportResult(savecard);
 		}
 	}
 
-	// compare(2, 3);
+	_interface.reportFinished();
+}
 
-	return _ok;
+/*
+ * Opens the savecard in the global thread pool.
+ * The progress is reported per slot, and the future can be canceled.
+ * The caller takes ownership of the result, there is no result if
+ * the future was canceled.
+ */
+QFuture<SavecardData *> SavecardData::openAsync(const QString &path, quint8 slot,
+                                                const FF8Installation &ff8Installation,
+                                                OpenOptions openOptions)
+{
+	SavecardDataOpener *opener = new SavecardDataOpener(path, slot, ff8Installation, openOptions);
+	QFuture<SavecardData *> future = opener->future();
+	QThreadPool::globalInstance()->start(opener);
+	return future;
 }
 
 #ifndef Q_OS_WINRT
@@ -264,9 +303,28 @@ bool SavecardData::ps()
 		_hashSeed = fic.read(20);
 	}
 
-	fic.seek(start+128);
-	QByteArray header = fic.read(1920);//(128*15)
-	fic.seek(start+SAVE_SIZE);
+	const char *map = nullptr;
+
+	if(_openOptions.testFlag(MapFile)) {
+		unmapFile();
+		_mappedFile = new QFile(_path);
+		if(_mappedFile->open(QIODevice::ReadOnly)) {
+			map = (const char *)_mappedFile->map(0, start+131072);
+		}
+		if(!map) { // Fallback to read
+			delete _mappedFile;
+			_mappedFile = nullptr;
+		}
+	}
+
+	QByteArray header;
+	if(map) {
+		header = QByteArray::fromRawData(map + start+128, 1920);
+	} else {
+		fic.seek(start+128);
+		header = fic.read(1920);//(128*15)
+		fic.seek(start+SAVE_SIZE);
+	}
 
 	quint8 blockCount = 1;
 	bool occupied;
@@ -283,7 +341,12 @@ bool SavecardData::ps()
 			occupied = false;
 		}
 
-		addSave(fic.read(SAVE_SIZE), header.mid(128*i, 127), occupied);
+		if(map) {
+			addSave(QByteArray::fromRawData(map + start+SAVE_SIZE*(i+1), SAVE_SIZE),
+			        QByteArray::fromRawData(map + start+128*(i+1), 127), occupied, true);
+		} else {
+			addSave(fic.read(SAVE_SIZE), header.mid(128*i, 127), occupied);
+		}
 	}
 
 #ifndef Q_OS_WINRT
@@ -346,148 +409,341 @@ bool SavecardData::ps3()
 
 bool SavecardData::pc(const QString &path)
 {
-	qint32 sizeC;
-	QFile f(path.isEmpty() ? _path : path);
+	PcFile pcFile = readPc(path.isEmpty() ? _path : path);
 
-	if(!f.exists() || !f.open(QIODevice::ReadOnly) || f.size() > SAVE_SIZE * 8) {
+	if(!pcFile.ok) {
 		return false;
 	}
 
+	addPc(pcFile);
+
+//#ifndef Q_OS_WINRT
+//	if(fileWatcher.files().size()<30)
+//		fileWatcher.addPath(_path);
+//#endif
+
+	return true;
+}
+
+/*
+ * Reads and decompresses one PC/Switch save file.
+ * Does not touch any member, so it can run in a worker thread.
+ */
+SavecardData::PcFile SavecardData::readPc(const QString &path)
+{
+	PcFile pcFile;
+	qint32 sizeC;
+	QFile f(path);
+
+	if(!f.exists()) {
+		return pcFile;
+	}
+	pcFile.exists = true;
+
+	if(!f.open(QIODevice::ReadOnly)) {
+		pcFile.errorString = QObject::tr("Le fichier est protégé en lecture.");
+		return pcFile;
+	}
+	if(f.size() > SAVE_SIZE * 8) {
+		pcFile.errorString = QObject::tr("Fichier trop gros");
+		return pcFile;
+	}
+
+	pcFile.fileSize = f.size();
+
 	f.read((char *)&sizeC, 4);
 	qint32 sizeC2;
 	f.read((char *)&sizeC2, 4);
 
 	if(sizeC == sizeC2 + 4) {
-		setType(Switch);
-		_switchSaveSize = f.size();
+		pcFile.type = Switch;
 	} else {
 		// Revert previous move
 		f.seek(f.pos() - 4);
 	}
 
-	if(type() != Switch && sizeC != f.size()-4) {
+	if(pcFile.type != Switch && sizeC != f.size()-4) {
 		quint16 header = sizeC & 0xFFFF;
 		if(header == 0x4353) { // SC
 			f.reset();
-			addSave(f.read(FF8SAVE_SIZE));
+			pcFile.data = f.read(FF8SAVE_SIZE);
+			pcFile.type = PcUncompressed;
+			pcFile.ok = true;
 
-			setType(PcUncompressed);
-
-			return true;
+			return pcFile;
 		}
 	}
 
-	addSave(LZS::decompress(f.readAll(), FF8SAVE_SIZE));
+	LZSDevice lzs(&f);
+	lzs.setMaximumSize(FF8SAVE_SIZE);
+	if(!lzs.open(QIODevice::ReadOnly)) {
+		pcFile.errorString = QObject::tr("Impossible de décompresser le fichier");
+		return pcFile;
+	}
 
-//#ifndef Q_OS_WINRT
-//	if(fileWatcher.files().size()<30)
-//		fileWatcher.addPath(_path);
-//#endif
+	pcFile.data = lzs.read(FF8SAVE_SIZE);
+	pcFile.ok = true;
 
-	return true;
+	return pcFile;
 }
 
-bool SavecardData::getFormatFromRaw()
+void SavecardData::addPc(const PcFile &pcFile)
 {
-	QFile f(_path);
-	start = 0;
-	_ok = false;
+	if(pcFile.type == Switch) {
+		setType(Switch);
+		_switchSaveSize = pcFile.fileSize;
+	} else if(pcFile.type == PcUncompressed) {
+		setType(PcUncompressed);
+	}
 
-	setErrorString(QString());
+	addSave(pcFile.data);
+}
 
-	if(!f.exists() || !f.open(QIODevice::ReadOnly)) {
-		setErrorString(QObject::tr("Impossible d'ouvrir le fichier"));
-		return false;
+static inline qint32 readInt32(const QByteArray &head, int offset)
+{
+	qint32 value;
+	memcpy(&value, head.constData() + offset, 4);
+	return value;
+}
+
+static int matchPs(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(!head.startsWith("MC") || fileSize < 131072) {
+		return 0;
 	}
+	return fileSize == 131072 ? 100 : 80;
+}
 
-	QByteArray data = f.read(10000);
+static int matchVgs(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(head.mid(64, 2) != "MC" || fileSize < 64 + 131072) {
+		return 0;
+	}
+	return head.startsWith("VgsM") ? 100 : 60;
+}
 
-	int indexMC = data.indexOf("MC");
-	if(indexMC != -1) { // Maybe Memory Card format
-		start = indexMC;
-		switch(indexMC) {
-		case 0:
-			_type = Ps;
-			break;
-		case 64:
-			_type = Vgs;
-			break;
-		case 128:
-			_type = Vmp;
-			break;
-		case 3904:
-			_type = Gme;
-			break;
-		default:
-			setType(Undefined);
-			start = indexMC;
-			break;
-		}
-		_ok = ps();
-		return _ok;
-	} else { // Maybe PC format
-		if(data.startsWith("SC")) {
-			_ok = pc();
-			return _ok;
-		}
+static int matchVmp(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(head.mid(128, 2) != "MC" || fileSize < 128 + 131072) {
+		return 0;
+	}
+	return head.startsWith(QByteArray("\x00PMV", 4)) ? 100 : 60;
+}
 
-		// compressed?
-		if (data.size() > 4) {
-			qint32 compressedOffset = -1, lzsSize;
-			memcpy(&lzsSize, data.constData(), 4);
+static int matchGme(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(head.mid(3904, 2) != "MC" || fileSize < 3904 + 131072) {
+		return 0;
+	}
+	return head.startsWith("123-456-STD") ? 100 : 60;
+}
 
-			if(lzsSize + 4 == f.size()) {
-				compressedOffset = 4;
-			} else {
-				quint32 lzsSize2;
-				memcpy(&lzsSize2, data.constData() + 4, 4);
+// Memory card at an unknown offset
+static int matchMemoryCard(const QByteArray &head, qint64 fileSize, quint16 &start)
+{
+	int index = head.indexOf("MC");
+	if(index < 0 || fileSize < index + 131072) {
+		return 0;
+	}
+	start = quint16(index);
+	return 10;
+}
 
-				if(lzsSize == lzsSize2 + 4) {
-					compressedOffset = 8;
-				}
-			}
+static int matchPsv(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(!head.startsWith(QByteArray("\x00VSP", 4)) || fileSize < 8324) {
+		return 0;
+	}
+	return 100;
+}
 
-			if(compressedOffset >= 0) {
-				_ok = pc();
-				return _ok;
-			}
-		}
+static int matchPc(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(head.size() < 4 || fileSize > SAVE_SIZE * 8) {
+		return 0;
+	}
+	// Switch layout: the size of the compressed data follows
+	if(head.size() >= 8 && readInt32(head, 0) == readInt32(head, 4) + 4) {
+		return 0;
+	}
+	return readInt32(head, 0) == fileSize - 4 ? 90 : 0;
+}
+
+static int matchSwitch(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(head.size() < 8 || fileSize > SAVE_SIZE * 8) {
+		return 0;
+	}
+	qint32 size = readInt32(head, 4);
+	return size > 0 && readInt32(head, 0) == size + 4 && size + 8 <= fileSize ? 90 : 0;
+}
+
+static int matchPcUncompressed(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(!head.startsWith("SC") || fileSize < FF8SAVE_SIZE || fileSize > SAVE_SIZE * 8) {
+		return 0;
+	}
+	quint16 ff8;
+	memcpy(&ff8, head.constData() + 386, 2);
+	// PC Demo is 0xFF8
+	return ff8 == 0x8FF || ff8 == 0xFF8 ? 100 : 50;
+}
+
+static int matchEPSXe(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(fileSize < SSTATE_SAVE_SIZE) {
+		return 0;
+	}
+	if(head.startsWith("ePSXe")) {
+		return 100;
+	}
+	if(!head.startsWith("\x1f\x8b")) {
+		return 0;
+	}
+	// The magic is compressed: inflate the beginning of the head
+	const QByteArray state = GZIP::decompress(head, 5);
+	if(state.size() < 5) {
+		return 10; // Unverified gzip
+	}
+	return state.startsWith("ePSXe") ? 100 : 0;
+}
 
-		if(data.indexOf("VSP") == 1) {
-			_type = Psv;
-			_ok = ps3();
+static int matchPSX(const QByteArray &head, qint64 fileSize, quint16 &)
+{
+	if(head.mid(1, 6) != "RS2CPU" || fileSize < SSTATE_SAVE_SIZE) {
+		return 0;
+	}
+	return 100;
+}
 
-			return _ok;
+/*
+ * Known formats, sorted by the number of bytes needed to recognize them.
+ * Undefined is for save states and memory cards inside another file:
+ * they must be saved as another file.
+ */
+const QList<SavecardData::Probe> &SavecardData::probes()
+{
+	static const QList<Probe> probes = QList<Probe>()
+		<< Probe(Ps, 2, matchPs, [](SavecardData *d) { return d->ps(); })
+		<< Probe(Psv, 4, matchPsv, [](SavecardData *d) { return d->ps3(); })
+		<< Probe(Undefined, 7, matchPSX, [](SavecardData *d) { return d->sstate_pSX(); })
+		<< Probe(Pc, 8, matchPc, [](SavecardData *d) { return d->pc(); })
+		<< Probe(Switch, 8, matchSwitch, [](SavecardData *d) { return d->pc(); })
+		<< Probe(Vgs, 66, matchVgs, [](SavecardData *d) { return d->ps(); })
+		<< Probe(Vmp, 130, matchVmp, [](SavecardData *d) { return d->ps(); })
+		<< Probe(PcUncompressed, 388, matchPcUncompressed, [](SavecardData *d) { return d->pc(); })
+		// Enough compressed bytes to inflate the magic
+		<< Probe(Undefined, 512, matchEPSXe, [](SavecardData *d) { return d->sstate_ePSXe(); })
+		<< Probe(Gme, 3906, matchGme, [](SavecardData *d) { return d->ps(); })
+		<< Probe(Undefined, 10000, matchMemoryCard, [](SavecardData *d) { return d->ps(); });
+	return probes;
+}
+
+/*
+ * Detects the format from the content, whatever the extension is.
+ * The beginning of the file is read once, only as far as the probes need.
+ */
+bool SavecardData::openFromContent()
+{
+	QFile f(_path);
+	setErrorString(QString());
+
+	if(!f.exists())
+	{
+		setType(Unknown);
+		setErrorString(QObject::tr("Le fichier n'existe plus.\n%1").arg(_path));
+		return false;
+	}
+	if(!f.open(QIODevice::ReadOnly))
+	{
+		setType(Unknown);
+		setErrorString(QObject::tr("Le fichier est protégé en lecture."));
+		return false;
+	}
+
+	const qint64 fileSize = f.size();
+	QByteArray head;
+	const Probe *best = nullptr;
+	int bestScore = 0;
+	quint16 bestStart = 0;
+
+	for(const Probe &probe : probes()) {
+		if(head.size() < probe.headSize && head.size() < fileSize) {
+			head.append(f.read(probe.headSize - head.size()));
+		}
+
+		quint16 probeStart = 0;
+		int score = probe.match(head, fileSize, probeStart);
+		if(score > bestScore) {
+			best = &probe;
+			bestScore = score;
+			bestStart = probeStart;
 		}
 	}
 
-	setErrorString(QObject::tr("Rien trouvé"));
+	f.close();
 
-	return false;
+	if(!best) {
+		setType(Unknown);
+		setErrorString(QObject::tr("Fichier de type inconnu."));
+		return false;
+	}
+
+	if(best->type == Undefined) {
+		// Read at the found offset, then the file is renamed "Sans nom"
+		start = bestStart;
+		bool ok = best->read(this);
+		setType(Undefined);
+		return ok;
+	}
+
+	setType(best->type);
+	if(bestStart) {
+		start = bestStart;
+	}
+
+	return best->read(this);
 }
 
 bool SavecardData::sstate_ePSXe()
 {
-	QTemporaryFile temp;
+	QFile f(_path);
 	setErrorString(QString());
 
-	if(!temp.open()) {
-		setErrorString(QObject::tr("Impossible de créer le fichier temporaire."));
+	if(!f.open(QIODevice::ReadOnly)) {
+		setErrorString(QObject::tr("Le fichier est protégé en lecture."));
 		return false;
 	}
-	if(!GZIP::decompress(_path, temp.fileName())) {
+
+	// Known offsets first: inflate only up to the end of the save data
+	{
+		GZIPDevice gzip(&f);
+		if(!gzip.open(QIODevice::ReadOnly)) {
+			setErrorString(QObject::tr("Impossible de décompresser le fichier."));
+			return false;
+		}
+
+		QByteArray MCHeader, save;
+		if(gzip.skipTo(0xBC42)) {
+			MCHeader = gzip.read(SSTATE_MCHEADER_SIZE);
+			if(gzip.skipTo(0x779CC)) {
+				save = gzip.read(SSTATE_SAVE_SIZE);
+			}
+		}
+
+		if(sstateAt(save, MCHeader)) {
+			return true;
+		}
+	}
+
+	// Other versions of ePSXe: the state is inflated again and searched
+	GZIPDevice gzip(&f);
+	if(!f.seek(0) || !gzip.open(QIODevice::ReadOnly)) {
 		setErrorString(QObject::tr("Impossible de décompresser le fichier."));
 		return false;
 	}
-//	temp.seek(7);
-//	QString serial(temp.read(11));
 
-	temp.seek(0xBC42);
-	QByteArray MCHeader = temp.read(0x20);
-
-	temp.seek(0x779CC);
-
-	return sstate(temp.read(0x139E), MCHeader);
+	return sstate(&gzip);
 }
 
 bool SavecardData::sstate_pSX()
@@ -500,16 +756,82 @@ bool SavecardData::sstate_pSX()
 		return false;
 	}
 
-	f.seek(0xBD38);
-	QByteArray MCHeader = f.read(0x20);
+	QByteArray MCHeader, save;
+	if(f.seek(0xBD38)) {
+		MCHeader = f.read(SSTATE_MCHEADER_SIZE);
+		if(f.seek(0x77AC2)) {
+			save = f.read(SSTATE_SAVE_SIZE);
+		}
+	}
+
+	if(sstateAt(save, MCHeader)) {
+		return true;
+	}
+
+	// Other versions of pSX: the state is searched
+	f.seek(0);
+
+	return sstate(&f);
+}
+
+/*
+ * Save and memory card header read at the offsets of known
+ * emulator versions, used only if their signatures match.
+ */
+bool SavecardData::sstateAt(const QByteArray &save, QByteArray MCHeader)
+{
+	// Matches only with "FF-8" at its place in the save
+	if(SaveLocator::findSaves(save).isEmpty()) {
+		return false;
+	}
+	if(SaveLocator::findMCHeaders(MCHeader).isEmpty()) {
+		MCHeader.clear();
+	}
+
+	return sstate(save, MCHeader);
+}
+
+/*
+ * The offsets of the save and of the memory card header in the state
+ * change with the emulator version, so they are searched in the state,
+ * and the most plausible ones are kept.
+ */
+bool SavecardData::sstate(QIODevice *state)
+{
+	QList<SaveLocator::Candidate> saves, MCHeaders;
+	SaveLocator::scan(state, SSTATE_MAX_SIZE, saves, MCHeaders);
+
+	if(saves.isEmpty()) {
+		setErrorString(QObject::tr("Aucune sauvegarde de Final Fantasy VIII trouvée."));
+		return false;
+	}
+
+	QByteArray MCHeader;
+
+	if(!MCHeaders.isEmpty()) {
+		MCHeader = MCHeaders.first().data;
+	}
 
-	f.seek(0x77AC2);
+	for(const SaveLocator::Candidate &save : saves) {
+		if(sstate(save.data, MCHeader)) {
+			return true;
+		}
+	}
 
-	return sstate(f.read(0x139E), MCHeader);
+	return false;
+}
+
+// libhyne is a static library, its resources must be registered by hand
+static bool initResources()
+{
+	Q_INIT_RESOURCE(libhyne);
+	return true;
 }
 
 bool SavecardData::sstate(const QByteArray &fdata, const QByteArray &MCHeader)
 {
+	static const bool resourcesLoaded = initResources();
+	Q_UNUSED(resourcesLoaded)
 	QByteArray squallIcon;
 
 	QFile iconFile(":/data/icon0.psico");
@@ -529,7 +851,7 @@ bool SavecardData::sstate(const QByteArray &fdata, const QByteArray &MCHeader)
 	data.append("\x00\x00", 2); // CRC
 	data.append(fdata);
 
-	if(data.size() != 0x139E + 0x182) {
+	if(data.size() != SSTATE_SAVE_SIZE + 0x182) {
 		setErrorString(QObject::tr("Format invalide."));
 		return false;
 	}
@@ -552,22 +874,75 @@ bool SavecardData::sstate(const QByteArray &fdata, const QByteArray &MCHeader)
 void SavecardData::directory(const QString &filePattern)
 {
 	QString dirname = this->dirname();
+	QStringList paths, errors;
 
 	for(quint8 i=0 ; i<30 ; ++i) {
 		QString path = filePattern;
 		QString num = QString("%1").arg(i + 1, 2, 10, QChar('0'));
-		path = dirname + path.replace("{num}", num);
-		if(!pc(path)) {
+		paths.append(dirname + path.replace("{num}", num));
+	}
+
+	if(_progress) {
+		_progress->setProgressRange(0, paths.size());
+	}
+
+	// Files are read and decompressed in the global thread pool,
+	// saves are added in slot order
+	QFuture<PcFile> future = QtConcurrent::mapped(paths, &SavecardData::readPc);
+	if(_progress) {
+		// openAsync() runs in the pool: do not hold a thread while waiting
+		QThreadPool::globalInstance()->releaseThread();
+	}
+
+	for(int i=0 ; i<paths.size() ; ++i) {
+		if(_progress && _progress->isCanceled()) {
+			future.cancel();
+			break;
+		}
+
+		const PcFile pcFile = future.resultAt(i);
+
+		if(pcFile.ok) {
+			addPc(pcFile);
+		} else {
+			if(pcFile.exists) {
+				errors.append(QObject::tr("Slot %1 : %2").arg(i + 1).arg(pcFile.errorString));
+			}
 			addSave(); // Empty save
 		}
+
+		if(_progress) {
+			_progress->setProgressValue(i + 1);
+		}
+	}
+
+	future.waitForFinished();
+	if(_progress) {
+		QThreadPool::globalInstance()->reserveThread();
 	}
 
-	LZS::clear();
+	setErrorString(errors.join("\n"));
+}
+
+void SavecardData::addSave(const QByteArray &data, const QByteArray &header, bool occupied, bool sharedData)
+{
+	saves.append(new SaveData(saves.size(), data, header, type()!=Psv, occupied, sharedData,
+	                          _openOptions.testFlag(LazyParsing)));
 }
 
-void SavecardData::addSave(const QByteArray &data, const QByteArray &header, bool occupied)
+void SavecardData::unmapFile()
 {
-	saves.append(new SaveData(saves.size(), data, header, type()!=Psv, occupied));
+	if(!_mappedFile) {
+		return;
+	}
+
+	// Saves must not reference the mapping anymore
+	for(SaveData *save : qAsConst(saves)) {
+		save->detachData();
+	}
+
+	delete _mappedFile;
+	_mappedFile = nullptr;
 }
 
 void SavecardData::moveSave(int sourceID, int targetID)
@@ -598,7 +973,8 @@ int SavecardData::saveCount() const
 bool SavecardData::saveMemoryCard(const QString &saveAs, Type newType)
 {
 	const QString path = saveAs.isEmpty() ? _path : saveAs;
-	QTemporaryFile temp;
+	QByteArray data;
+	QList<QByteArray> segments;
 	QFile fic(_path);
 	setErrorString(QString());
 
@@ -606,6 +982,15 @@ bool SavecardData::saveMemoryCard(const QString &saveAs, Type newType)
 		newType = _type;
 	}
 
+	if(path == _path) {
+		unmapFile();
+
+		// Only the modified saves are written
+		if(newType == _type && !_isModified && saveMemoryCardInPlace(!saveAs.isEmpty())) {
+			return true;
+		}
+	}
+
 	if(!fic.exists())
 	{
 		setErrorString(QObject::tr("Le fichier n'existe plus.\n%1").arg(_path));
@@ -616,19 +1001,13 @@ bool SavecardData::saveMemoryCard(const QString &saveAs, Type newType)
 		setErrorString(QObject::tr("Le fichier est protégé en lecture.\n%1").arg(_path));
 		return false;
 	}
-	if(!temp.open())
-	{
-		fic.close();
-		setErrorString(QObject::tr("Impossible de créer un fichier temporaire"));
-		return false;
-	}
 
 	if(!isOne(_type) && _type != PcSlot)
 	{
 		quint8 i;
 		SaveData *save;
 
-		QByteArray data = header(&fic, newType, !saveAs.isEmpty());
+		data = header(&fic, newType, !saveAs.isEmpty());
 
 		data.append("MC", 2);//MC
 		data.append(125, '\0');
@@ -653,20 +1032,21 @@ bool SavecardData::saveMemoryCard(const QString &saveAs, Type newType)
 
 		data.append(fic.read(6144));//Padding (8192-16*128)
 
+		// The blocks are shared with the saves, the card is never concatenated
+		segments.append(data);
+
 		for(i=0 ; i<15 ; ++i)
 		{
 			save = saves.at(i);
 
 //			compare(fic.peek(FF8SAVE_SIZE), save->save());
-			data.append(save->save());
+			segments.append(save->save());
 		}
 
 		if(newType == Vmp) {
 			// Rehash
-			data = CryptographicHash::hashVmp(data);
+			CryptographicHash::hashVmp(segments);
 		}
-
-		temp.write(data);
 	}
 	else
 	{
@@ -676,54 +1056,96 @@ bool SavecardData::saveMemoryCard(const QString &saveAs, Type newType)
 
 	fic.close();
 
+	return writeFile(path, segments);
+}
+
+static bool syncFile(QFile &f)
+{
+	if(!f.flush()) {
+		return false;
+	}
+#ifdef Q_OS_WIN
+	return _commit(f.handle()) == 0;
+#else
+	return fsync(f.handle()) == 0;
+#endif
+}
+
+/*
+ * Writes in the current file only the directory frames and the blocks
+ * of the modified saves (and the description for Gme).
+ * Unlike writeFile(), a crash can leave a block half written, but each
+ * block is independent and has its own checksum. Vmp is excluded: its
+ * hash covers the whole file and would be stale until written last.
+ * Returns false when the full file must be written instead.
+ */
+bool SavecardData::saveMemoryCardInPlace(bool saveAs)
+{
+	if(isOne(_type) || _type == PcSlot || _type == Vmp || saves.size() != 15) {
+		return false;
+	}
+
+	QFile fic(_path);
+	if(!fic.open(QIODevice::ReadWrite) || fic.size() < start + 131072) {
+		return false;
+	}
+
+	QMap<qint64, QByteArray> patches;
+
+	if(_type == Gme && saveAs) {
+		QByteArray description = _description.leftJustified(3840, '\0', true);
+		if(!fic.seek(64) || fic.read(3840) != description) {
+			patches.insert(64, description);
+		}
+	}
+
+	for(quint8 i=0 ; i<15 ; ++i) {
+		SaveData *save = saves.at(i);
+
+		if(!save->isModified()) {
+			continue;
+		}
+
+		if(save->hasMCHeader()) {
+			patches.insert(start + 128 * (i + 1), save->saveMCHeader());
+		}
+		patches.insert(start + SAVE_SIZE * (i + 1), save->save());
+	}
+
 #ifndef Q_OS_WINRT
 	bool readdPath = false;
-	if(fileWatcher.files().contains(path))
+	if(fileWatcher.files().contains(_path))
 	{
 		readdPath = true;
-		fileWatcher.removePath(path);
+		fileWatcher.removePath(_path);
 	}
 #endif
 
-	if(QFile::exists(path) && !QFile::remove(path))
-	{
-		temp.close();
-		setErrorString(QObject::tr("Impossible de supprimer le fichier !\n%1\nÉchec de la sauvegarde.\nVérifiez que le fichier n'est pas utilisé par un autre programme.").arg(path));
-#ifndef Q_OS_WINRT
-		if(readdPath)	fileWatcher.addPath(path);
-#endif
-		return false;
+	bool ok = true;
+	QMapIterator<qint64, QByteArray> it(patches);
+	while(ok && it.hasNext()) {
+		it.next();
+		ok = fic.seek(it.key()) && fic.write(it.value()) == it.value().size();
 	}
-	if(!temp.copy(path))
-	{
-		setErrorString(QObject::tr("Échec de la sauvegarde."));
+
+	// Success is reported only once the blocks are on the disk
+	if(ok && _syncPolicy == SyncEachFile) {
+		ok = syncFile(fic);
 	}
+
 #ifndef Q_OS_WINRT
-	if(readdPath)	fileWatcher.addPath(path);
+	if(readdPath)	fileWatcher.addPath(_path);
 #endif
 
-	return true;
+	return ok;
 }
 
-bool SavecardData::saveOne(const SaveData *save, const QString &saveAs, Type newType)
+bool SavecardData::saveOne(const SaveData *save, const QString &saveAs, Type newType, LZS::Level level)
 {
 	setErrorString(QString());
 
 	const QString path = saveAs.isEmpty() ? _path : saveAs;
 
-	QTemporaryFile temp;
-	if(!temp.open()) {
-		setErrorString(QObject::tr("Impossible de créer un fichier temporaire"));
-		return false;
-	}
-
-#ifndef Q_OS_WINRT
-	bool readdPath = false;
-	if(fileWatcher.files().contains(path)) {
-		readdPath = true;
-		fileWatcher.removePath(path);
-	}
-#endif
 	UserDirectory userDirectory;
 	quint8 slot=0, num=0;
 
@@ -750,6 +1172,9 @@ bool SavecardData::saveOne(const SaveData *save, const QString &saveAs, Type new
 		}
 
 		if(save->isDelete()) {
+#ifndef Q_OS_WINRT
+			fileWatcher.removePath(path);
+#endif
 			QFile::remove(path);
 
 			// Rerelease 2013: removing from metadata file
@@ -773,7 +1198,6 @@ bool SavecardData::saveOne(const SaveData *save, const QString &saveAs, Type new
 			setErrorString(QObject::tr("Pas de MC Header défini."));
 			return false;
 		}
-		QByteArray result;
 		result.append("\0VSP\0\0\0\0", 8);
 		if(!_hashSeed.isEmpty()) {
 			result.append(_hashSeed.leftJustified(20, '\0', true));
@@ -788,19 +1212,28 @@ bool SavecardData::saveOne(const SaveData *save, const QString &saveAs, Type new
 					  "\x03\x90\x00\x00", 52); // unknown (type 1 = PS1 or 2 = PS2 at offset 12)
 		result.append(save->MCHeader().mid(10, 32).leftJustified(32, '\0')); // Country + prod code + identifier
 		result.append(save->save());
-		temp.write(CryptographicHash::hashPsv(result));
+		result = CryptographicHash::hashPsv(result);
 	} else {
-		result = LZS::compress(save->save());
-		int size = result.size();
-		result.prepend((char *)&size, 4);
+		// Compress after the size header(s), filled afterwards
+		const int headerSize = newType == Switch ? 8 : 4;
+		QByteArray data = save->save();
+		LZS *lzs = new LZS();
+		result.resize(headerSize + LZS::compressBound(data.size()));
+		int size = lzs->compress(data.constData(), data.size(), result.data() + headerSize, level);
+		delete lzs;
+		result.truncate(headerSize + size);
+
 		if(newType == Switch) {
 			// Header with size again
-			size += 4;
-			result.prepend((char *)&size, 4);
+			int switchSize = size + 4;
+			memcpy(result.data(), &switchSize, 4);
+			memcpy(result.data() + 4, &size, 4);
 			// Padding at the end
 			if (result.size() < _switchSaveSize) {
 				result.append(_switchSaveSize - result.size(), '\0');
 			}
+		} else {
+			memcpy(result.data(), &size, 4);
 		}
 	}
 
@@ -814,24 +1247,9 @@ bool SavecardData::saveOne(const SaveData *save, const QString &saveAs, Type new
 		}
 	}
 
-	temp.write(result);
-
-	if(QFile::exists(path) && !QFile::remove(path))
-	{
-		setErrorString(QObject::tr("Impossible de supprimer le fichier !\n%1\nÉchec de la sauvegarde.\nEssayez de lancer %2 en tant qu'administrateur.")
-				.arg(path).arg(PROG_NAME));
-#ifndef Q_OS_WINRT
-		if(readdPath)	fileWatcher.addPath(path);
-#endif
+	if(!writeFile(path, result)) {
 		return false;
 	}
-	if(!temp.copy(path))
-	{
-		setErrorString(QObject::tr("Échec de la sauvegarde."));
-	}
-#ifndef Q_OS_WINRT
-	if(readdPath)	fileWatcher.addPath(path);
-#endif
 
 	if(_type == Undefined) {
 		setPath(path);
@@ -843,14 +1261,11 @@ bool SavecardData::saveOne(const SaveData *save, const QString &saveAs, Type new
 
 bool SavecardData::save2PS(const QList<int> &ids, const QString &path, const Type newType, const QByteArray &MCHeader)
 {
-	QTemporaryFile temp;
 	quint8 i;
 	setErrorString(QString());
 
-	if(!temp.open())
-	{
-		setErrorString(QObject::tr("Impossible de créer un fichier temporaire"));
-		return false;
+	if(path == _path) {
+		unmapFile();
 	}
 
 	QByteArray data;
@@ -883,53 +1298,31 @@ bool SavecardData::save2PS(const QList<int> &ids, const QString &path, const Typ
 
 	data.append(6144, '\0');//Padding
 
+	QList<QByteArray> segments;
+	const QByteArray emptySave(SAVE_SIZE, '\0');
+	segments.append(data);
+
 	for(i=0 ; i<15 ; ++i)
 	{
-		// 8192 bytes
-		if(i >= ids.size() || !saves.at(ids.at(i))->isFF8())
+		// 8192 bytes, other games are kept with their own directory frame
+		if(i >= ids.size() || (!MCHeader.isEmpty() && !saves.at(ids.at(i))->isFF8()))
 		{
-			data.append(SAVE_SIZE, '\0');
+			segments.append(emptySave);
 		}
 		else
 		{
-			data.append(saves.at(ids.at(i))->save());
+			segments.append(saves.at(ids.at(i))->save());
 		}
 	}
 
 	if(newType == Vmp) {
 		// Rehash
-		data = CryptographicHash::hashVmp(data);
+		CryptographicHash::hashVmp(segments);
 	}
 
-	temp.write(data);
-
-#ifndef Q_OS_WINRT
-	bool readdPath = false;
-	if(fileWatcher.files().contains(path))
-	{
-		readdPath = true;
-		fileWatcher.removePath(path);
-	}
-#endif
-
-	if(QFile::exists(path) && !QFile::remove(path))
-	{
-		setErrorString(QObject::tr("Impossible de supprimer le fichier !"
-								 "\n%1\nÉchec de la sauvegarde."
-								 "\nVérifiez que le fichier n'est pas utilisé"
-								 " par un autre programme.").arg(path));
-#ifndef Q_OS_WINRT
-		if(readdPath)	fileWatcher.addPath(path);
-#endif
+	if(!writeFile(path, segments)) {
 		return false;
 	}
-	if(!temp.copy(path))
-	{
-		setErrorString(QObject::tr("Échec de la sauvegarde."));
-	}
-#ifndef Q_OS_WINRT
-	if(readdPath)	fileWatcher.addPath(path);
-#endif
 
 	if(_type == Undefined) {
 		setPath(path);
@@ -1017,7 +1410,150 @@ QByteArray SavecardData::header(QFile *srcFile, Type newType, bool saveAs)
 		return QByteArray();
 }
 
-bool SavecardData::saveDirectory(const QString &dir)
+static bool renameOverwrite(const QString &oldName, const QString &newName)
+{
+#ifdef Q_OS_WIN
+	return MoveFileExW((LPCWSTR)QDir::toNativeSeparators(oldName).utf16(),
+	                   (LPCWSTR)QDir::toNativeSeparators(newName).utf16(),
+	                   MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	// POSIX rename replaces the target atomically
+	return ::rename(QFile::encodeName(oldName).constData(),
+	                QFile::encodeName(newName).constData()) == 0;
+#endif
+}
+
+/*
+ * Writes the segments one after the other, with a single vectored
+ * write when the system has one.
+ */
+static bool writeSegments(QFileDevice &f, const QList<QByteArray> &segments, QString &errorString)
+{
+#ifdef Q_OS_WIN
+	for(const QByteArray &segment : segments) {
+		if(f.write(segment) != segment.size()) {
+			errorString = f.errorString();
+			return false;
+		}
+	}
+	if(!f.flush()) {
+		errorString = f.errorString();
+		return false;
+	}
+	return true;
+#else
+	QVarLengthArray<struct iovec, 32> iov;
+	for(const QByteArray &segment : segments) {
+		if(!segment.isEmpty()) {
+			struct iovec vec;
+			vec.iov_base = const_cast<char *>(segment.constData());
+			vec.iov_len = size_t(segment.size());
+			iov.append(vec);
+		}
+	}
+
+	// Nothing must stay in the buffer of f
+	if(!f.flush()) {
+		errorString = f.errorString();
+		return false;
+	}
+
+	struct iovec *cur = iov.data();
+	int count = iov.size();
+	while(count > 0) {
+		ssize_t written = ::writev(f.handle(), cur, qMin(count, IOV_MAX));
+		if(written < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			errorString = qt_error_string(errno);
+			return false;
+		}
+		// Partial write: skip what was written
+		while(count > 0 && size_t(written) >= cur->iov_len) {
+			written -= cur->iov_len;
+			++cur;
+			--count;
+		}
+		if(count > 0) {
+			cur->iov_base = static_cast<char *>(cur->iov_base) + written;
+			cur->iov_len -= size_t(written);
+		}
+	}
+	return true;
+#endif
+}
+
+bool SavecardData::writeFile(const QString &path, const QByteArray &data)
+{
+	return writeFile(path, QList<QByteArray>() << data);
+}
+
+/*
+ * Replaces the file at path by the segments: the data is written once
+ * in a file next to the target, which is renamed over the target, so
+ * the target is never missing or partially written.
+ */
+bool SavecardData::writeFile(const QString &path, const QList<QByteArray> &segments)
+{
+	QString errorString;
+	bool ok;
+
+#ifndef Q_OS_WINRT
+	bool readdPath = false;
+	if(fileWatcher.files().contains(path))
+	{
+		readdPath = true;
+		fileWatcher.removePath(path);
+	}
+#endif
+
+	if(_syncPolicy == SyncEachFile) {
+		// QSaveFile flushes the data to the disk before renaming
+		QSaveFile f(path);
+		ok = f.open(QIODevice::WriteOnly);
+		if(!ok) {
+			errorString = f.errorString();
+		} else if(!writeSegments(f, segments, errorString)) {
+			f.cancelWriting();
+			ok = false;
+		} else if(!f.commit()) {
+			errorString = f.errorString();
+			ok = false;
+		}
+	} else {
+		QTemporaryFile f(path + ".XXXXXX");
+		ok = f.open() && writeSegments(f, segments, errorString);
+		if(ok) {
+			// Keep the permissions of the target, QTemporaryFile creates private files
+			f.setPermissions(QFile::exists(path)
+			                 ? QFile::permissions(path)
+			                 : QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup | QFile::ReadOther);
+			f.close();
+			ok = renameOverwrite(f.fileName(), path);
+			if(ok) {
+				f.setAutoRemove(false);
+			}
+		} else if(errorString.isEmpty()) {
+			errorString = f.errorString();
+		}
+	}
+
+#ifndef Q_OS_WINRT
+	if(readdPath)	fileWatcher.addPath(path);
+#endif
+
+	if(!ok) {
+		setErrorString(QObject::tr("Impossible d'écrire le fichier !"
+		                           "\n%1\nÉchec de la sauvegarde."
+		                           "\nVérifiez que le fichier n'est pas utilisé"
+		                           " par un autre programme.\n%2").arg(path, errorString));
+	}
+
+	return ok;
+}
+
+bool SavecardData::saveDirectory(const QString &dir, LZS::Level level)
 {
 	QString dirname = dir.isEmpty() ? this->dirname() : dir, filePattern;
 	bool ok = true;
@@ -1030,7 +1566,7 @@ bool SavecardData::saveDirectory(const QString &dir)
 			QString num = QString("%1").arg(i + 1, 2, 10, QChar('0'));
 			QString path = filePattern;
 
-			if(!saveOne(save, dirname + path.replace("{num}", num), SavecardData::Pc)) {
+			if(!saveOne(save, dirname + path.replace("{num}", num), SavecardData::Pc, level)) {
 				ok = false;
 			}
 		}
@@ -1040,6 +1576,132 @@ bool SavecardData::saveDirectory(const QString &dir)
 	return ok;
 }
 
+/*
+ * The slots which have not changed since the base snapshot
+ * share their data with it.
+ */
+SavecardData::Snapshot SavecardData::currentState(const Snapshot *base) const
+{
+	Snapshot state;
+	state.parent = _currentSnapshot;
+
+	for(int i = 0 ; i < saves.size() ; ++i) {
+		const SaveData *save = saves.at(i);
+		const QByteArray data = save->save();
+		const QByteArray &MCHeader = save->MCHeader();
+
+		if(base && i < base->saves.size() && base->saves.at(i) == data) {
+			state.saves.append(base->saves.at(i));
+		} else {
+			state.saves.append(data);
+		}
+
+		if(base && i < base->MCHeaders.size() && base->MCHeaders.at(i) == MCHeader) {
+			state.MCHeaders.append(base->MCHeaders.at(i));
+		} else {
+			// Can be a view on the mapped file
+			state.MCHeaders.append(QByteArray(MCHeader.constData(), MCHeader.size()));
+		}
+	}
+
+	return state;
+}
+
+/*
+ * Records the saves in the history, as a child of the current
+ * snapshot: after a revert, the next snapshot starts a new branch.
+ * Returns the snapshot ID.
+ */
+int SavecardData::snapshot(const QString &label)
+{
+	Snapshot state = currentState(_currentSnapshot >= 0 ? &_snapshots.at(_currentSnapshot) : nullptr);
+	state.label = label;
+
+	_snapshots.append(state);
+	_currentSnapshot = _snapshots.size() - 1;
+
+	return _currentSnapshot;
+}
+
+/*
+ * Restores the saves of a snapshot, only the slots which differ are reopened.
+ */
+bool SavecardData::revert(int snapshotID)
+{
+	if(snapshotID < 0 || snapshotID >= _snapshots.size()) {
+		return false;
+	}
+
+	const Snapshot &snapshot = _snapshots.at(snapshotID);
+	const int count = qMin(saves.size(), snapshot.saves.size());
+
+	for(int i = 0 ; i < count ; ++i) {
+		SaveData *save = saves.at(i);
+
+		if(save->save() != snapshot.saves.at(i)
+		        || save->MCHeader() != snapshot.MCHeaders.at(i)) {
+			save->open(snapshot.saves.at(i), snapshot.MCHeaders.at(i));
+			save->setModified(true);
+			_isModified = true;
+		}
+	}
+
+	_currentSnapshot = snapshotID;
+
+	return true;
+}
+
+/*
+ * Returns the slots which differ between two snapshots,
+ * or between a snapshot and the current saves when otherID is -1.
+ */
+QList<int> SavecardData::diff(int snapshotID, int otherID) const
+{
+	QList<int> ret;
+
+	if(snapshotID < 0 || snapshotID >= _snapshots.size()
+	        || otherID < -1 || otherID >= _snapshots.size()) {
+		return ret;
+	}
+
+	const Snapshot &snapshot = _snapshots.at(snapshotID);
+	const Snapshot other = otherID < 0 ? currentState(&snapshot) : _snapshots.at(otherID);
+	const int count = qMax(snapshot.saves.size(), other.saves.size());
+
+	for(int i = 0 ; i < count ; ++i) {
+		if(i >= snapshot.saves.size() || i >= other.saves.size()) {
+			ret.append(i);
+			continue;
+		}
+
+		const QByteArray &a = snapshot.saves.at(i), &b = other.saves.at(i);
+		const QByteArray &headerA = snapshot.MCHeaders.at(i), &headerB = other.MCHeaders.at(i);
+		// Shared data: no need to compare
+		if((a.constData() != b.constData() && a != b)
+		        || (headerA.constData() != headerB.constData() && headerA != headerB)) {
+			ret.append(i);
+		}
+	}
+
+	return ret;
+}
+
+int SavecardData::snapshotParent(int snapshotID) const
+{
+	if(snapshotID < 0 || snapshotID >= _snapshots.size()) {
+		return -1;
+	}
+	return _snapshots.at(snapshotID).parent;
+}
+
+QString SavecardData::snapshotLabel(int snapshotID) const
+{
+	if(snapshotID < 0 || snapshotID >= _snapshots.size()) {
+		return QString();
+	}
+	return _snapshots.at(snapshotID).label;
+}
+
 void SavecardData::compare(quint8 idLeft, quint8 idRight) const
 {
 	if (qMax(idLeft, idRight) < saves.count()) {
@@ -1051,43 +1713,31 @@ void SavecardData::compare(quint8 idLeft, quint8 idRight) const
 
 void SavecardData::compare(const QByteArray &oldData, const QByteArray &newData)
 {
+	constexpr int headerPos = 388, mainPos = headerPos + int(sizeof(HEADER));
+	// Field script vars (MISC3 and FIELD)
+	constexpr int varsPos = mainPos + SaveFields::offset(SaveFields::mainStruct, "misc3"),
+	        varsEnd = mainPos + SaveFields::offset(SaveFields::mainStruct, "worldmap");
+
 	qDebug() << "Compare ----";
 	for(int i=386 ; i<FF8SAVE_SIZE ; ++i) {
-		switch(i) {
-		case 0:
-			qDebug() << "\tHeader1";break;
-		case 386:
-			qDebug() << "\tHeader2";break;
-		case 464:
-			qDebug() << "\tGF";break;
-		case 1552:
-			qDebug() << "\tPerso";break;
-		case 2768:
-			qDebug() << "\tBoutiques";break;
-		case 3168:
-			qDebug() << "\tConfig";break;
-		case 3188:
-			qDebug() << "\tDivers 1";break;
-		case 3220:
-			qDebug() << "\tLimit Break";break;
-		case 3236:
-			qDebug() << "\tObjets";break;
-		case 3664:
-			qDebug() << "\tStats";break;
-		case 3808:
-			qDebug() << "\tVar map 1";break;
-		case 4064:
-			qDebug() << "\tVar map 2";break;
-		case 5088:
-			qDebug() << "\tMappemonde";break;
-		case 5216:
-			qDebug() << "\tTriple Triad Cards";break;
-		case 5344:
-			qDebug() << "\tChocobo";break;
+		if(i == headerPos) {
+			qDebug() << "\t" << SaveFields::headerStruct.name;
+		} else if(i >= mainPos) {
+			const SaveStruct &fields = SaveFields::mainStruct;
+			for(int j=0 ; j<fields.count ; ++j) {
+				if(i - mainPos == fields.fields[j].offset) {
+					qDebug() << "\t" << fields.fields[j].name;
+				}
+			}
 		}
 
 		if(oldData.at(i)!=newData.at(i)) {
-			qDebug() << QString("Difference at %1: %2 (%3) | %4 (%5)%6").arg(i).arg((quint8)oldData.at(i),2,16,QChar('0')).arg((quint8)oldData.at(i),8,2,QChar('0')).arg((quint8)newData.at(i),2,16,QChar('0')).arg((quint8)newData.at(i),8,2,QChar('0')).arg(i >= 3808 && i<5088 ? QString(" var%1").arg(i-3808) : "").toLatin1().constData();
+			const QString field = i < headerPos
+			        ? QString("ff8")
+			        : i < mainPos
+			          ? SaveFields::path(SaveFields::headerStruct, i - headerPos)
+			          : SaveFields::path(SaveFields::mainStruct, i - mainPos);
+			qDebug() << QString("Difference at %1 (%7): %2 (%3) | %4 (%5)%6").arg(i).arg((quint8)oldData.at(i),2,16,QChar('0')).arg((quint8)oldData.at(i),8,2,QChar('0')).arg((quint8)newData.at(i),2,16,QChar('0')).arg((quint8)newData.at(i),8,2,QChar('0')).arg(i >= varsPos && i<varsEnd ? QString(" var%1").arg(i-varsPos) : "").arg(field).toLatin1().constData();
 		}
 	}
 }
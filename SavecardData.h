@@ -21,6 +21,7 @@
 
 #include <QtCore>
 #include "SaveData.h"
+#include "LZS.h"
 #include "UserDirectory.h"
 #include "FF8Installation.h"
 
@@ -30,16 +31,30 @@ public:
 	enum Type {
 		Pc, PcUncompressed, Switch, Ps, Vgs, Gme, Vmp, Psv, PcSlot, Unknown, Undefined
 	};
+	enum OpenOption {
+		NoOption = 0x0,
+		MapFile = 0x1, // Memory cards: saves reference a mapping of the file until modified, for short-lived uses only
+		LazyParsing = 0x2 // Icon, HEADER and MAIN are decoded on first access
+	};
+	Q_DECLARE_FLAGS(OpenOptions, OpenOption)
+	enum SyncPolicy {
+		SyncEachFile, // Saved files are flushed to the disk before replacing the target
+		NoSync // Faster for batches, the target is still replaced atomically
+	};
 
 	inline static bool isOne(Type type) {
 		return type == Pc || type == PcUncompressed || type == Switch || type == Psv;
 	}
 
-	explicit SavecardData(const QString &path, quint8 slot=0, const FF8Installation &ff8Installation=FF8Installation());
+	explicit SavecardData(const QString &path, quint8 slot=0, const FF8Installation &ff8Installation=FF8Installation(),
+	                      OpenOptions openOptions=NoOption);
 	explicit SavecardData(int saveCount);
 	virtual ~SavecardData();
 
 	bool open(const QString &path, quint8 slot=0);
+	static QFuture<SavecardData *> openAsync(const QString &path, quint8 slot=0,
+	                                         const FF8Installation &ff8Installation=FF8Installation(),
+	                                         OpenOptions openOptions=NoOption);
 #ifndef Q_OS_WINRT
 	const QFileSystemWatcher *watcher() const;
 #endif
@@ -58,9 +73,15 @@ public:
 	SaveData *getSave(int id) const;
 	int saveCount() const;
 	bool saveMemoryCard(const QString &saveAs, Type newType);
-	bool saveOne(const SaveData *save, const QString &saveAs, Type newType);
+	bool saveOne(const SaveData *save, const QString &saveAs, Type newType, LZS::Level level = LZS::Tree);
 	bool save2PS(const QList<int> &ids, const QString &path, const Type newType, const QByteArray &MCHeader);
-	bool saveDirectory(const QString &dir = QString());
+	bool saveDirectory(const QString &dir = QString(), LZS::Level level = LZS::Tree);
+	inline SyncPolicy syncPolicy() const {
+		return _syncPolicy;
+	}
+	inline void setSyncPolicy(SyncPolicy syncPolicy) {
+		_syncPolicy = syncPolicy;
+	}
 
 	QString dirname() const;
 	QString name() const;
@@ -79,6 +100,10 @@ public:
 	inline quint8 slotNumber() const {
 		return _slot;
 	}
+	// Slot used by saveDirectory() to name the files
+	inline void setSlotNumber(quint8 slot) {
+		_slot = slot;
+	}
 	bool hasPath() const;
 	bool isModified() const;
 	void setModified(bool modified);
@@ -86,24 +111,74 @@ public:
 		return _ff8Installation;
 	}
 
+	// History of the saves, see snapshot()
+	int snapshot(const QString &label = QString());
+	bool revert(int snapshotID);
+	QList<int> diff(int snapshotID, int otherID = -1) const;
+	inline int snapshotCount() const {
+		return _snapshots.size();
+	}
+	inline int currentSnapshot() const {
+		return _currentSnapshot;
+	}
+	int snapshotParent(int snapshotID) const;
+	QString snapshotLabel(int snapshotID) const;
+
 	void compare(quint8 idLeft, quint8 idRight) const;
 	static void compare(const QByteArray &oldData, const QByteArray &newData);
 
-	bool getFormatFromRaw();
 private:
+	friend class SavecardDataOpener;
+	struct PcFile {
+		PcFile() : type(Pc), fileSize(0), exists(false), ok(false) {}
+		QByteArray data;
+		QString errorString;
+		Type type; // Pc, PcUncompressed or Switch
+		qint64 fileSize;
+		bool exists, ok;
+	};
+	struct Snapshot {
+		QString label;
+		int parent;
+		// Implicitly shared with the parent when the slot has not changed
+		QList<QByteArray> saves, MCHeaders;
+	};
+	struct Probe {
+		Probe(Type type, int headSize, int (*match)(const QByteArray &, qint64, quint16 &),
+		      bool (*read)(SavecardData *)) :
+		    type(type), headSize(headSize), match(match), read(read) {}
+		Type type;
+		int headSize; // Bytes needed at the beginning of the file
+		// Returns a score (0: no match, 100: sure), can set the start of the data
+		int (*match)(const QByteArray &head, qint64 fileSize, quint16 &start);
+		bool (*read)(SavecardData *savecard);
+	};
+
+	SavecardData(quint8 slot, const FF8Installation &ff8Installation, OpenOptions openOptions);
 	inline void setPath(const QString &path) {
 		_path = path;
 	}
 	void setType(Type type);
+	static const QList<Probe> &probes();
+	bool openFromContent();
 	bool ps();
 	bool ps3();
 	bool pc(const QString &path = QString());
+	static PcFile readPc(const QString &path);
+	void addPc(const PcFile &pcFile);
 	bool sstate_ePSXe();
 	bool sstate_pSX();
+	bool sstateAt(const QByteArray &save, QByteArray MCHeader);
+	bool sstate(QIODevice *state);
 	bool sstate(const QByteArray &fdata, const QByteArray &MCHeader);
 	void directory(const QString &filePattern);
-	void addSave(const QByteArray &data=QByteArray(), const QByteArray &header=QByteArray(), bool occupied=false);
+	void addSave(const QByteArray &data=QByteArray(), const QByteArray &header=QByteArray(), bool occupied=false, bool sharedData=false);
+	void unmapFile();
 	QByteArray header(QFile *srcFile, Type newType, bool saveAs);
+	bool writeFile(const QString &path, const QByteArray &data);
+	bool writeFile(const QString &path, const QList<QByteArray> &segments);
+	bool saveMemoryCardInPlace(bool saveAs);
+	Snapshot currentState(const Snapshot *base) const;
 	inline void setErrorString(const QString &errorString) {
 		_lastError = errorString;
 	}
@@ -122,6 +197,14 @@ private:
 	QByteArray _hashSeed;
 	qint64 _switchSaveSize;
 	const FF8Installation _ff8Installation;
+	OpenOptions _openOptions;
+	QFile *_mappedFile;
+	QFutureInterfaceBase *_progress; // Set by openAsync()
+	SyncPolicy _syncPolicy;
+	QList<Snapshot> _snapshots;
+	int _currentSnapshot;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(SavecardData::OpenOptions)
+
 #endif
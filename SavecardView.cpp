@@ -20,7 +20,8 @@
 #include "HeaderDialog.h"
 #include "Config.h"
 #include "Data.h"
-#include "FF8Text.h"
+#include "FF8Font.h"
+#include "SaveIcon.h"
 
 SavecardView::SavecardView(SavecardWidget *parent) :
 	QWidget(parent), cursorID(-1), blackID(-1),
@@ -514,12 +515,12 @@ void SavecardView::renderSave(QPainter *painter, const SaveData *saveData, const
 		if(!(toBePainted & QRect(271, 8, saveWidth()-271, 24)).isEmpty()) {
 			int persoIndex = saveData->constDescData().party[0] != 255 ? saveData->constDescData().party[0] : (saveData->constDescData().party[1] != 255 ? saveData->constDescData().party[1] : saveData->constDescData().party[2]);
 			bool langIndep = persoIndex==SQUALL || persoIndex==RINOA || persoIndex==GRIEVER || persoIndex==BOKO || persoIndex==ANGELO;
-			FF8Text::drawTextArea(painter, QPoint(271, 8), saveData->perso(persoIndex), langIndep ? (saveData->isJp() ? 2 : 1) : 0);
+			FF8Font::drawTextArea(painter, QPoint(271, 8), saveData->perso(persoIndex), langIndep ? (saveData->isJp() ? 2 : 1) : 0);
 		}
 
 		// Level
 		if(!(toBePainted & QRect(271, 36, saveWidth()-271, 24)).isEmpty()) {
-			FF8Text::drawTextArea(painter, QPoint(271, 36), tr("NV%1").arg(saveData->constDescData().nivLeader,3,10,QChar(' ')), 1);
+			FF8Font::drawTextArea(painter, QPoint(271, 36), tr("NV%1").arg(saveData->constDescData().nivLeader,3,10,QChar(' ')), 1);
 		}
 
 		// Disc number
@@ -557,7 +558,7 @@ void SavecardView::renderSave(QPainter *painter, const SaveData *saveData, const
 
 			// Location
 			if(!(toBePainted & QRect(256+12, 62+12, saveWidth()-(256+12), 24)).isEmpty()) {
-				FF8Text::drawTextArea(painter, QPoint(12, 12), saveData->constDescData().locationID<251 ? Data::locations().at(saveData->constDescData().locationID) : QString("??? (%1)").arg(saveData->constDescData().locationID));
+				FF8Font::drawTextArea(painter, QPoint(12, 12), saveData->constDescData().locationID<251 ? Data::locations().at(saveData->constDescData().locationID) : QString("??? (%1)").arg(saveData->constDescData().locationID));
 			}
 		}
 	}
@@ -567,17 +568,17 @@ void SavecardView::renderSave(QPainter *painter, const SaveData *saveData, const
 			if(saveData->isRaw())
 			{
 				// Unavailable block
-				FF8Text::drawTextArea(painter, QPoint(36, 43), tr("Bloc occupé"));
+				FF8Font::drawTextArea(painter, QPoint(36, 43), tr("Bloc occupé"));
 			}
 			else if(saveData->isDelete())
 			{
 				// Available block
-				FF8Text::drawTextArea(painter, QPoint(36, 43), tr("Bloc Disponible"));
+				FF8Font::drawTextArea(painter, QPoint(36, 43), tr("Bloc Disponible"));
 			}
 			else
 			{
 				// Icon + description
-				painter->drawPixmap(36, 44, saveData->saveIcon().icon(currentIconFrame % saveData->saveIcon().nbFrames()));
+				painter->drawPixmap(36, 44, SaveIcon::icon(saveData->saveIcon(), currentIconFrame % saveData->saveIcon().nbFrames()));
 				QString short_desc = saveData->shortDescription();
 				if(!short_desc.isEmpty())
 				{
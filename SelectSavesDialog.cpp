@@ -17,6 +17,7 @@
  ****************************************************************************/
 
 #include "SelectSavesDialog.h"
+#include "SaveIcon.h"
 
 SelectSavesDialog::SelectSavesDialog(const QList<SaveData *> &saveFiles, bool multiSelection, bool onlyFF8, QWidget *parent) :
 	QDialog(parent, Qt::Dialog | Qt::WindowCloseButtonHint)
@@ -85,7 +86,7 @@ void SelectSavesDialog::fillList(const QList<SaveData *> &saveFiles)
 		                                            .arg(shortDescription.isEmpty()
 		                                                 ? tr("vide")
 		                                                 : shortDescription));
-		item->setIcon(save->saveIcon().icon());
+		item->setIcon(SaveIcon::icon(save->saveIcon()));
 		list->addItem(item);
 		item->setData(Qt::UserRole, i);
 	}
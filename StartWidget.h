@@ -19,7 +19,7 @@
 #define STARTWIDGET_H
 
 #include <QtWidgets>
-#include "FF8Text.h"
+#include "FF8Font.h"
 
 #define OPTION_WIDTH	250
 #define OPTION_HEIGHT	42
@@ -22,10 +22,15 @@
 #include "HeaderDialog.h"
 #include "SCHeaderDialog.h"
 #include "MetadataDialog.h"
+#include "SaveIcon.h"
 
 Window::Window(bool isNew) :
-	QWidget(), taskbarButton(0), saves(0), saveList(0), editor(0)
+	QWidget(), taskbarButton(0), saves(0), openProgress(0), openingType(File),
+	saveList(0), editor(0)
 {
+	openWatcher = new QFutureWatcher<SavecardData *>(this);
+	connect(openWatcher, SIGNAL(finished()), SLOT(openFileFinished()));
+
 	setTitle();
 	setMinimumSize(768, 502);
 	resize(768, 502);
@@ -164,6 +169,11 @@ Window::Window(bool isNew) :
 
 Window::~Window()
 {
+	if(openWatcher->isRunning()) {
+		openWatcher->cancel();
+		openWatcher->waitForFinished();
+		qDeleteAll(openWatcher->future().results());
+	}
 	Config::setValue(Config::Geometry, saveGeometry());
 	Config::saveRecentFiles();
 	Config::sync();// flush data
@@ -343,18 +353,37 @@ bool Window::closeFile(bool quit)
 
 void Window::openFile(const QString &path, OpenType openType, const FF8Installation &installation)
 {
-	if(!closeFile())	return;
+	if(openWatcher->isRunning() || !closeFile())	return;
 
-	saves = new SavecardData(path, quint8(openType), installation);
-	if(saves->type() == SavecardData::Unknown) {
-		QMessageBox::StandardButton rep = QMessageBox::question(this, tr("Erreur"), tr("Fichier de type inconnu.\nVoulez-vous l'analyser pour obtenir le bon format ?"), QMessageBox::Yes | QMessageBox::No);
-		if(rep != QMessageBox::Yes) {
-			return;
-		}
+	openingType = openType;
+
+	openProgress = new QProgressDialog(tr("Ouverture..."), tr("Annuler"), 0, 0, this, Qt::Dialog | Qt::WindowCloseButtonHint);
+	openProgress->setWindowModality(Qt::WindowModal);
+	openProgress->setMinimumDuration(500);
+	connect(openWatcher, SIGNAL(progressRangeChanged(int,int)), openProgress, SLOT(setRange(int,int)));
+	connect(openWatcher, SIGNAL(progressValueChanged(int)), openProgress, SLOT(setValue(int)));
+	connect(openProgress, SIGNAL(canceled()), openWatcher, SLOT(cancel()));
+
+	// No MapFile: the card stays open for the whole session, and can be
+	// truncated or rewritten by an emulator meanwhile
+	openWatcher->setFuture(SavecardData::openAsync(path, quint8(openType), installation,
+	                                               SavecardData::LazyParsing));
+}
+
+void Window::openFileFinished()
+{
+	openProgress->deleteLater();
+	openProgress = 0;
+
+	QFuture<SavecardData *> future = openWatcher->future();
 
-		saves->getFormatFromRaw();
+	if(future.isCanceled()) {
+		qDeleteAll(future.results());
+		return;
 	}
 
+	saves = future.result();
+
 	if(!saves->isOpen())
 	{
 		QMessageBox::warning(this, tr("Erreur"), saves->errorString());
@@ -362,13 +391,17 @@ void Window::openFile(const QString &path, OpenType openType, const FF8Installat
 	}
 	else
 	{
+		if(openingType != File && !saves->errorString().isEmpty()) { // Slot errors
+			QMessageBox::warning(this, tr("Erreur"), saves->errorString());
+		}
+
 		saveView();
 		saveList->setSavecard(saves);
 
 		setIsOpen(true);
 		setModified(saves->isModified());
 
-		if(openType == File) {
+		if(openingType == File) {
 			Config::addRecentFile(saves->path());
 			fillMenuRecent();
 		}
@@ -679,8 +712,8 @@ void Window::editView(SaveData *saveData)
 	stackedLayout->setCurrentWidget(editor);
 	setTitle(saveData->id());
 	saves->setIsTheLastEdited(saveData->id());
-	if(taskbarButton)	taskbarButton->setOverlayIcon(saveData->saveIcon().icon());
-	else				setWindowIcon(QIcon(saveData->saveIcon().icon()));
+	if(taskbarButton)	taskbarButton->setOverlayIcon(SaveIcon::icon(saveData->saveIcon()));
+	else				setWindowIcon(QIcon(SaveIcon::icon(saveData->saveIcon())));
 }
 
 void Window::saveView()
@@ -753,7 +786,7 @@ void Window::changeFrame(QAction *action)
 void Window::font(bool font)
 {
 	Config::setValue(Config::Font, font ? "hr" : "");
-	FF8Text::reloadFont();
+	FF8Font::reload();
 	if(saves) {
 		saveList->view()->update();
 	} else {
@@ -46,6 +46,7 @@ private slots:
 	inline void slot1() { open(Slot1); }
 	inline void slot2() { open(Slot2); }
 	void open(OpenType=File);
+	void openFileFinished();
 	bool closeFile(bool quit=false);
 	void reload();
 	void openRecentFile(QAction *);
@@ -82,6 +83,9 @@ private:
 	QMenu *menuRecent, *menuFrame, *menuLang, *menuVersion;
 	QStackedLayout *stackedLayout;
 	SavecardData *saves;
+	QFutureWatcher<SavecardData *> *openWatcher;
+	QProgressDialog *openProgress;
+	OpenType openingType;
 	SavecardWidget *saveList;
 	StartWidget *startWidget;
 	Editor *editor;
@@ -0,0 +1,583 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#include "HyneCli.h"
+#include "../CryptographicHash.h"
+#include "../Crc16.h"
+#include "../SaveStore.h"
+#include "../Config.h"
+#include "../Data.h"
+
+HyneCli::HyneCli() :
+	_command(NoCommand), _type(SavecardData::Unknown),
+	_syncPolicy(SavecardData::SyncEachFile), _level(LZS::Tree),
+	_country(COUNTRY_US), _slot(-1), _slotDir(0)
+{
+}
+
+bool HyneCli::setCommand(const QString &command)
+{
+	if(command == "info") {
+		_command = Info;
+	} else if(command == "convert") {
+		_command = Convert;
+	} else if(command == "extract") {
+		_command = Extract;
+	} else if(command == "verify") {
+		_command = Verify;
+	} else if(command == "pack") {
+		_command = Pack;
+	} else if(command == "import") {
+		_command = Import;
+	} else if(command == "export") {
+		_command = Export;
+	} else if(command == "bench") {
+		_command = Bench;
+	} else {
+		_command = NoCommand;
+		return false;
+	}
+	return true;
+}
+
+QString HyneCli::typeName(SavecardData::Type type)
+{
+	switch(type) {
+	case SavecardData::Pc:				return "pc";
+	case SavecardData::PcUncompressed:	return "ps4";
+	case SavecardData::Switch:			return "switch";
+	case SavecardData::Ps:				return "ps";
+	case SavecardData::Vgs:				return "vgs";
+	case SavecardData::Gme:				return "gme";
+	case SavecardData::Vmp:				return "vmp";
+	case SavecardData::Psv:				return "psv";
+	case SavecardData::PcSlot:			return "pcslot";
+	case SavecardData::Undefined:		return "savestate";
+	case SavecardData::Unknown:			break;
+	}
+	return "unknown";
+}
+
+QStringList HyneCli::typeNames()
+{
+	return QStringList() << "pc" << "ps4" << "switch" << "ps" << "vgs" << "gme" << "vmp" << "psv" << "pcslot";
+}
+
+bool HyneCli::setType(const QString &type)
+{
+	for(int t = SavecardData::Pc ; t <= SavecardData::PcSlot ; ++t) {
+		if(typeName(SavecardData::Type(t)) == type) {
+			_type = SavecardData::Type(t);
+			return true;
+		}
+	}
+	return false;
+}
+
+QString HyneCli::levelName(LZS::Level level)
+{
+	switch(level) {
+	case LZS::Tree:		return "tree";
+	case LZS::Fast:		return "fast";
+	case LZS::Default:	return "default";
+	case LZS::Best:		return "best";
+	case LZS::Optimal:	return "optimal";
+	}
+	return QString();
+}
+
+QStringList HyneCli::levelNames()
+{
+	return QStringList() << "tree" << "fast" << "default" << "best" << "optimal";
+}
+
+bool HyneCli::setLevel(const QString &level)
+{
+	for(int l = LZS::Tree ; l <= LZS::Optimal ; ++l) {
+		if(levelName(LZS::Level(l)) == level) {
+			_level = LZS::Level(l);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool HyneCli::setRegion(const QString &region)
+{
+	if(region == "jp") {
+		_country = COUNTRY_JP;
+	} else if(region == "us") {
+		_country = COUNTRY_US;
+	} else if(region == "eu") {
+		_country = COUNTRY_EU;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+QString HyneCli::extension(SavecardData::Type type)
+{
+	switch(type) {
+	case SavecardData::Pc:
+	case SavecardData::PcUncompressed:	return ".ff8";
+	case SavecardData::Ps:				return ".mcr";
+	case SavecardData::Vgs:				return ".vgs";
+	case SavecardData::Gme:				return ".gme";
+	case SavecardData::Vmp:				return ".vmp";
+	case SavecardData::Psv:				return ".psv";
+	default:							break;
+	}
+	return QString();
+}
+
+QString HyneCli::outputPath(const QString &path, int slot) const
+{
+	// Slot directories end with a '/'
+	QString name = QFileInfo(QDir::cleanPath(path)).completeBaseName();
+	if(slot >= 0) {
+		name.append(QString("-%1").arg(slot + 1, 2, 10, QChar('0')));
+	}
+	return QDir(_output).filePath(name + extension(_type));
+}
+
+QByteArray HyneCli::MCHeader() const
+{
+	SaveData save;
+	QString code;
+
+	switch(_country) {
+	case COUNTRY_JP:	code = "SLPSP01880";	break;
+	case COUNTRY_EU:	code = "SLESP02080";	break;
+	default:			code = "SLUSP00892";	break;
+	}
+
+	save.setMCHeader(true, _country, code, QString());
+
+	return save.saveMCHeader();
+}
+
+HyneCli::Result HyneCli::operator()(const QString &path) const
+{
+	Result result;
+
+	if(_command == Export) {
+		return exportCard(path);
+	}
+
+	SavecardData savecard(path, _slotDir, FF8Installation(FF8Installation::Steam),
+	                      SavecardData::MapFile | SavecardData::LazyParsing);
+
+	if(!savecard.isOpen()) {
+		result.ok = false;
+		result.errorString = QString("%1: %2").arg(path, savecard.errorString());
+		return result;
+	}
+
+	savecard.setSyncPolicy(_syncPolicy);
+
+	switch(_command) {
+	case Info:		return info(savecard, path);
+	case Convert:	return convert(savecard, path);
+	case Extract:	return extract(savecard, path);
+	case Verify:	return verify(savecard, path);
+	case Import:	return importCard(savecard, path);
+	case Bench:		return bench(savecard, path);
+	case Pack:
+	case Export:
+	case NoCommand:
+		break;
+	}
+
+	return result;
+}
+
+QString HyneCli::saveInfos(const SaveData *save)
+{
+	if(save->isDelete()) {
+		return QObject::tr("vide");
+	}
+	if(!save->isFF8()) {
+		return QObject::tr("autre jeu : %1").arg(save->shortDescription());
+	}
+
+	const HEADER &header = save->constDescData();
+
+	return QObject::tr("FF8 %1 Nv.%2 %3:%4 %5 gils CD %6")
+	        .arg(save->perso(SQUALL))
+	        .arg(header.nivLeader)
+	        .arg(Config::hour(header.time, save->freqValue()), 2, 10, QChar('0'))
+	        .arg(Config::min(header.time, save->freqValue()), 2, 10, QChar('0'))
+	        .arg(header.gils)
+	        .arg(header.disc + 1);
+}
+
+HyneCli::Result HyneCli::info(SavecardData &savecard, const QString &path) const
+{
+	Result result;
+	QTextStream out(&result.output);
+
+	out << path << ": " << typeName(savecard.type())
+	    << QObject::tr(", %n sauvegarde(s)", "", savecard.saveCount()) << "\n";
+
+	for(const SaveData *save : savecard.getSaves()) {
+		out << QString("  %1  ").arg(save->id() + 1, 2, 10, QChar('0'))
+		    << saveInfos(save) << "\n";
+	}
+
+	return result;
+}
+
+HyneCli::Result HyneCli::convert(SavecardData &savecard, const QString &path) const
+{
+	Result result;
+	const QString output = outputPath(path);
+	const SavecardData::Type type = savecard.type();
+
+	if(SavecardData::isOne(_type)) {
+		if(savecard.saveCount() != 1) {
+			result.ok = false;
+			result.errorString = QObject::tr("%1: plusieurs sauvegardes, utilisez la commande extract")
+			                     .arg(path);
+			return result;
+		}
+
+		SaveData *save = savecard.getSave(0);
+		if(_type == SavecardData::Psv && !save->hasMCHeader()) {
+			save->setMCHeader(MCHeader());
+		}
+
+		result.ok = savecard.saveOne(save, output, _type, _level);
+	} else if(_type == SavecardData::PcSlot) {
+		// output is a directory, named like the slot directory of the input if any
+		if(!QDir().mkpath(output)) {
+			result.ok = false;
+			result.errorString = QObject::tr("Impossible de créer le dossier %1.").arg(output);
+			return result;
+		}
+
+		// saveDirectory() writes only the modified saves
+		for(SaveData *save : savecard.getSaves()) {
+			if(save->isFF8() && !save->isDelete()) {
+				save->setModified(true);
+			}
+		}
+		savecard.setSlotNumber(_slotDir ? _slotDir : 1);
+		result.ok = savecard.saveDirectory(output + "/", _level);
+	} else if(SavecardData::isOne(type) || type == SavecardData::PcSlot
+	          || type == SavecardData::Undefined) {
+		QList<int> ids;
+		for(const SaveData *save : savecard.getSaves()) {
+			if(save->isFF8() && !save->isDelete() && ids.size() < 15) {
+				ids.append(save->id());
+			}
+		}
+		result.ok = savecard.save2PS(ids, output, _type, MCHeader());
+	} else {
+		result.ok = savecard.saveMemoryCard(output, _type);
+	}
+
+	if(result.ok) {
+		result.output = QString("%1 -> %2\n").arg(path, output);
+	} else {
+		result.errorString = QString("%1: %2").arg(path, savecard.errorString());
+	}
+
+	return result;
+}
+
+HyneCli::Result HyneCli::extract(SavecardData &savecard, const QString &path) const
+{
+	Result result;
+	QTextStream out(&result.output);
+
+	for(SaveData *save : savecard.getSaves()) {
+		if((_slot >= 0 && save->id() != _slot)
+		        || !save->isFF8() || save->isDelete()) {
+			continue;
+		}
+
+		const QString output = outputPath(path, save->id());
+
+		if(_type == SavecardData::Psv && !save->hasMCHeader()) {
+			save->setMCHeader(MCHeader());
+		}
+
+		if(savecard.saveOne(save, output, _type, _level)) {
+			out << path << " -> " << output << "\n";
+		} else {
+			result.ok = false;
+			result.errorString.append(QString("%1: %2\n").arg(output, savecard.errorString()));
+		}
+	}
+
+	return result;
+}
+
+HyneCli::Result HyneCli::verify(SavecardData &savecard, const QString &path) const
+{
+	Result result;
+	QTextStream out(&result.output);
+
+	if(savecard.type() == SavecardData::Vmp || savecard.type() == SavecardData::Psv) {
+		QFile f(path);
+		if(f.open(QIODevice::ReadOnly)) {
+			QByteArray data = f.readAll();
+			QByteArray rehashed = savecard.type() == SavecardData::Vmp
+			                      ? CryptographicHash::hashVmp(data)
+			                      : CryptographicHash::hashPsv(data);
+			if(rehashed != data) {
+				result.ok = false;
+				out << path << ": " << QObject::tr("signature invalide") << "\n";
+			}
+		}
+	}
+
+	for(const SaveData *save : savecard.getSaves()) {
+		if(save->isFF8() && !save->isDelete() && !save->isChecksumValid()) {
+			result.ok = false;
+			out << path << QString(" %1: ").arg(save->id() + 1, 2, 10, QChar('0'))
+			    << QObject::tr("checksum invalide") << "\n";
+		}
+	}
+
+	if(result.ok) {
+		out << path << ": OK\n";
+	}
+
+	return result;
+}
+
+/*
+ * Each import is a new snapshot of the card, named after the file
+ * and its modification date.
+ */
+HyneCli::Result HyneCli::importCard(SavecardData &savecard, const QString &path) const
+{
+	Result result;
+	SaveStore store(_store);
+	const QFileInfo fileInfo(path);
+	const QString name = QString("%1/%2").arg(fileInfo.fileName(),
+	                                          fileInfo.lastModified().toString("yyyyMMdd-hhmmss"));
+
+	result.ok = store.importCard(&savecard, name);
+	if(result.ok) {
+		result.output = QString("%1 -> %2\n").arg(path, name);
+	} else {
+		result.errorString = QString("%1: %2").arg(path, store.errorString());
+	}
+
+	return result;
+}
+
+HyneCli::Result HyneCli::exportCard(const QString &name) const
+{
+	Result result;
+	SaveStore store(_store);
+	// "card.mcr/20261017-101010" -> "card-20261017-101010"
+	const QString base = QString("%1-%2").arg(QFileInfo(QFileInfo(name).path()).completeBaseName(),
+	                                          QFileInfo(name).fileName());
+	const QString output = _type == SavecardData::PcSlot
+	                       ? QDir(_output).filePath(base)
+	                       : outputPath(base);
+
+	result.ok = store.exportCard(name, output, _type, MCHeader(), _slot);
+	if(result.ok) {
+		result.output = QString("%1 -> %2\n").arg(name, output);
+	} else {
+		result.errorString = QString("%1: %2").arg(name, store.errorString());
+	}
+
+	return result;
+}
+
+HyneCli::Result HyneCli::pack(const QStringList &paths) const
+{
+	Result result;
+	SavecardData target(15);
+	QList<int> ids;
+
+	if(SavecardData::isOne(_type)) {
+		result.ok = false;
+		result.errorString = QObject::tr("%1 n'est pas un format de carte mémoire\n").arg(typeName(_type));
+		return result;
+	}
+
+	target.setSyncPolicy(_syncPolicy);
+
+	for(const QString &path : paths) {
+		SavecardData savecard(path, _slotDir, FF8Installation(FF8Installation::Steam));
+
+		if(!savecard.isOpen()) {
+			result.ok = false;
+			result.errorString.append(QString("%1: %2\n").arg(path, savecard.errorString()));
+			continue;
+		}
+
+		for(const SaveData *save : savecard.getSaves()) {
+			if(!save->isFF8() || save->isDelete()) {
+				continue;
+			}
+			if(ids.size() >= 15) {
+				result.ok = false;
+				result.errorString.append(QObject::tr("%1: plus de place sur la carte mémoire\n").arg(path));
+				break;
+			}
+			target.getSave(ids.size())->open(save->save(), QByteArray());
+			ids.append(ids.size());
+		}
+	}
+
+	if(!target.save2PS(ids, _output, _type, MCHeader())) {
+		result.ok = false;
+		result.errorString.append(QString("%1: %2\n").arg(_output, target.errorString()));
+	} else {
+		result.output = QObject::tr("%1 : %n sauvegarde(s)\n", "", ids.size()).arg(_output);
+	}
+
+	return result;
+}
+
+/*
+ * Known checksums, computed with the table of the game: its entry 0xFF
+ * is 0 instead of 0x1EF0 (0x7091 and 0x3c05 with the real CRC-16).
+ */
+bool HyneCli::checkCrc16(QString &errorString)
+{
+	QByteArray zeroes(4944, '\0'), pattern(4944, Qt::Uninitialized);
+	for(int i = 0 ; i < pattern.size() ; ++i) {
+		pattern[i] = char(i * 7);
+	}
+
+	const struct {
+		const QByteArray &data;
+		quint16 checksum;
+	} vectors[] = {
+		{ zeroes, 0xFFFF },
+		{ pattern, 0x671A }
+	};
+
+	for(const auto &vector : vectors) {
+		const char *data = vector.data.constData();
+		const int size = vector.data.size();
+		const quint16 sliced = ~Crc16::ff8(data, size),
+		        bytewise = ~Crc16::ff8Bytewise(data, size);
+		if(sliced != vector.checksum || bytewise != vector.checksum) {
+			errorString = QObject::tr("checksum incorrect : %1 et %2 au lieu de %3")
+			              .arg(sliced, 4, 16, QChar('0'))
+			              .arg(bytewise, 4, 16, QChar('0'))
+			              .arg(vector.checksum, 4, 16, QChar('0'));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Size and time of each LZS level on the FF8 saves of the file, as
+ * written in PC saves (8192 bytes block), then throughput of the
+ * checksum, checked against the value written in the blocks.
+ */
+HyneCli::Result HyneCli::bench(SavecardData &savecard, const QString &path) const
+{
+	Result result;
+	QTextStream out(&result.output);
+	QList<QByteArray> blocks;
+
+	for(const SaveData *save : savecard.getSaves()) {
+		if(save->isFF8() && !save->isDelete()) {
+			blocks.append(save->save());
+		}
+	}
+
+	if(blocks.isEmpty()) {
+		out << path << ": " << QObject::tr("aucune sauvegarde FF8") << "\n";
+		return result;
+	}
+
+	out << path << QObject::tr(", %n sauvegarde(s)", "", blocks.size()) << "\n";
+
+	QByteArray compressed(LZS::compressBound(SAVE_SIZE), Qt::Uninitialized);
+	LZS *lzs = new LZS();
+
+	for(int l = LZS::Tree ; l <= LZS::Optimal ; ++l) {
+		const LZS::Level level = LZS::Level(l);
+		qint64 size = 0;
+		int runs = 0;
+		QElapsedTimer timer;
+		timer.start();
+
+		// At least 200 ms per level
+		do {
+			size = 0;
+			for(const QByteArray &block : qAsConst(blocks)) {
+				size += lzs->compress(block.constData(), block.size(), compressed.data(), level);
+			}
+			++runs;
+		} while(timer.elapsed() < 200);
+
+		const qint64 usPerSave = timer.nsecsElapsed() / 1000 / (runs * blocks.size());
+		out << QString("  lzs %1 %2 %3 us/save\n")
+		       .arg(levelName(level), -8)
+		       .arg(QObject::tr("%1 octets").arg(size), -14)
+		       .arg(usPerSave);
+	}
+
+	delete lzs;
+
+	if(!checkCrc16(result.errorString)) {
+		result.ok = false;
+		return result;
+	}
+
+	for(const QByteArray &block : qAsConst(blocks)) {
+		quint16 stored;
+		memcpy(&stored, block.constData() + 384, 2);
+		if(quint16(~Crc16::ff8(block.constData() + 464, 4944)) != stored
+		        || Crc16::ff8(block.constData() + 464, 4944) != Crc16::ff8Bytewise(block.constData() + 464, 4944)) {
+			result.ok = false;
+			result.errorString = QObject::tr("%1: checksum incorrect").arg(path);
+			return result;
+		}
+	}
+
+	QString throughputs;
+	for(int bytewise = 0 ; bytewise < 2 ; ++bytewise) {
+		int runs = 0;
+		quint16 crc = 0;
+		QElapsedTimer timer;
+		timer.start();
+
+		do {
+			for(const QByteArray &block : qAsConst(blocks)) {
+				crc ^= bytewise ? Crc16::ff8Bytewise(block.constData() + 464, 4944)
+				                : Crc16::ff8(block.constData() + 464, 4944);
+			}
+			++runs;
+		} while(timer.elapsed() < 200);
+
+		// crc is printed so the loop is not optimized out
+		throughputs.append(QString(" %1 %2 Mo/s (%3)")
+		                   .arg(bytewise ? "bytewise" : "sliced")
+		                   .arg(4944.0 * runs * blocks.size() / timer.nsecsElapsed() * 1000.0, 0, 'f', 0)
+		                   .arg(crc, 4, 16, QChar('0')));
+	}
+	out << "  crc16" << throughputs << "\n";
+
+	return result;
+}
@@ -0,0 +1,97 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#ifndef HYNECLI_H
+#define HYNECLI_H
+
+#include <QtCore>
+#include "../SavecardData.h"
+
+/*
+ * Commands of hyne-cli, one input file per call, so they can run
+ * in a thread pool.
+ */
+class HyneCli
+{
+public:
+	enum Command {
+		Info, Convert, Extract, Verify, Pack, Import, Export, Bench, NoCommand
+	};
+
+	struct Result {
+		Result() : ok(true) {}
+		QString output, errorString;
+		bool ok;
+	};
+	typedef Result result_type; // QtConcurrent
+
+	HyneCli();
+	bool setCommand(const QString &command);
+	inline Command command() const {
+		return _command;
+	}
+	bool setType(const QString &type);
+	bool setRegion(const QString &region);
+	inline void setOutput(const QString &output) {
+		_output = output;
+	}
+	inline void setSlot(int slot) {
+		_slot = slot;
+	}
+	// Inputs are FF8 Steam slot directories (1 or 2), files if 0
+	inline void setSlotDir(quint8 slotDir) {
+		_slotDir = slotDir;
+	}
+	bool setLevel(const QString &level);
+	inline void setSyncPolicy(SavecardData::SyncPolicy syncPolicy) {
+		_syncPolicy = syncPolicy;
+	}
+	inline void setStore(const QString &store) {
+		_store = store;
+	}
+	Result operator()(const QString &path) const;
+	Result pack(const QStringList &paths) const;
+
+	static QString typeName(SavecardData::Type type);
+	static QStringList typeNames();
+	static QString levelName(LZS::Level level);
+	static QStringList levelNames();
+private:
+	Result info(SavecardData &savecard, const QString &path) const;
+	Result convert(SavecardData &savecard, const QString &path) const;
+	Result extract(SavecardData &savecard, const QString &path) const;
+	Result verify(SavecardData &savecard, const QString &path) const;
+	Result importCard(SavecardData &savecard, const QString &path) const;
+	Result exportCard(const QString &name) const;
+	Result bench(SavecardData &savecard, const QString &path) const;
+	QString outputPath(const QString &path, int slot = -1) const;
+	QByteArray MCHeader() const;
+	static QString extension(SavecardData::Type type);
+	static QString saveInfos(const SaveData *save);
+	static bool checkCrc16(QString &errorString);
+
+	Command _command;
+	SavecardData::Type _type;
+	SavecardData::SyncPolicy _syncPolicy;
+	LZS::Level _level;
+	QString _output, _store;
+	char _country;
+	int _slot;
+	quint8 _slotDir;
+};
+
+#endif // HYNECLI_H
@@ -0,0 +1,19 @@
+TEMPLATE = app
+TARGET = hyne-cli
+
+include(../hyne.pri)
+include(../libhyne/libhyne.pri)
+
+QT = core concurrent
+CONFIG += console
+CONFIG -= app_bundle
+
+# Input
+HEADERS += HyneCli.h
+SOURCES += main.cpp \
+    HyneCli.cpp
+
+unix:!macx {
+    target.path = /usr/bin
+    INSTALLS += target
+}
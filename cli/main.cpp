@@ -0,0 +1,185 @@
+/****************************************************************************
+ ** Hyne Final Fantasy VIII Save Editor
+ ** Copyright (C) 2009-2013 Arzel Jérôme <myst6re@gmail.com>
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU General Public License for more details.
+ **
+ ** You should have received a copy of the GNU General Public License
+ ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ****************************************************************************/
+#include <QtCore>
+#include <QtConcurrent>
+#include "HyneCli.h"
+#include "../Config.h"
+#include "../Parameters.h"
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	app.setApplicationName(PROG_NAME);
+	app.setApplicationVersion(PROG_VERSION);
+
+	QTranslator translator;
+	if(translator.load("hyne_" + QLocale::system().name().left(2), Config::translationDir())) {
+		app.installTranslator(&translator);
+	}
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QObject::tr("Éditeur de sauvegardes Final Fantasy VIII (sans interface)"));
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addPositionalArgument("commande", QObject::tr("info, convert, extract, verify, pack, import, export ou bench"));
+	parser.addPositionalArgument("fichiers", QObject::tr("Fichiers à traiter"), "<fichiers...>");
+
+	QCommandLineOption typeOption(QStringList() << "t" << "type",
+	                              QObject::tr("Format de destination (%1)").arg(HyneCli::typeNames().join(", ")),
+	                              "type");
+	QCommandLineOption outputOption(QStringList() << "o" << "output",
+	                                QObject::tr("Dossier de destination (fichier pour pack)"),
+	                                "chemin", ".");
+	QCommandLineOption slotOption(QStringList() << "s" << "slot",
+	                              QObject::tr("N'extraire que cette sauvegarde (1-15)"), "n");
+	QCommandLineOption slotDirOption("slot-dir",
+	                                 QObject::tr("Les fichiers sont des dossiers de slot de FF8 Steam (1 ou 2)"), "slot");
+	QCommandLineOption regionOption(QStringList() << "r" << "region",
+	                                QObject::tr("Région des en-têtes créés (jp, us, eu)"), "region", "us");
+	QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+	                              QObject::tr("Nombre de fichiers traités en parallèle"), "n");
+	QCommandLineOption levelOption(QStringList() << "l" << "level",
+	                               QObject::tr("Compression LZS (%1)").arg(HyneCli::levelNames().join(", ")),
+	                               "niveau", "tree");
+	QCommandLineOption storeOption("store",
+	                               QObject::tr("Dossier du stockage des sauvegardes (import, export)"), "chemin");
+	QCommandLineOption noSyncOption("no-sync",
+	                                QObject::tr("Ne pas attendre l'écriture sur le disque de chaque fichier"));
+
+	parser.addOption(typeOption);
+	parser.addOption(outputOption);
+	parser.addOption(slotOption);
+	parser.addOption(slotDirOption);
+	parser.addOption(regionOption);
+	parser.addOption(jobsOption);
+	parser.addOption(levelOption);
+	parser.addOption(storeOption);
+	parser.addOption(noSyncOption);
+	parser.process(app);
+
+	QTextStream err(stderr), out(stdout);
+	QStringList args = parser.positionalArguments();
+	HyneCli cli;
+
+	if(args.size() < 2 || !cli.setCommand(args.takeFirst())) {
+		parser.showHelp(1);
+	}
+
+	if(parser.isSet(typeOption)) {
+		if(!cli.setType(parser.value(typeOption))) {
+			err << QObject::tr("Type inconnu : %1").arg(parser.value(typeOption)) << "\n";
+			return 1;
+		}
+	} else if(cli.command() == HyneCli::Extract) {
+		cli.setType("pc");
+	} else if(cli.command() == HyneCli::Convert || cli.command() == HyneCli::Pack
+	          || cli.command() == HyneCli::Export) {
+		err << QObject::tr("Veuillez préciser le format de destination (--type)") << "\n";
+		return 1;
+	}
+
+	if(parser.value(typeOption) == "pcslot" && cli.command() != HyneCli::Convert
+	        && cli.command() != HyneCli::Export) {
+		err << QObject::tr("Le type pcslot n'est disponible que pour convert et export") << "\n";
+		return 1;
+	}
+
+	if(cli.command() == HyneCli::Import || cli.command() == HyneCli::Export) {
+		if(!parser.isSet(storeOption)) {
+			err << QObject::tr("Veuillez préciser le dossier du stockage (--store)") << "\n";
+			return 1;
+		}
+		cli.setStore(parser.value(storeOption));
+	}
+
+	if(!cli.setRegion(parser.value(regionOption))) {
+		err << QObject::tr("Région inconnue : %1").arg(parser.value(regionOption)) << "\n";
+		return 1;
+	}
+
+	if(parser.isSet(slotOption)) {
+		bool ok;
+		int slot = parser.value(slotOption).toInt(&ok);
+		if(!ok || slot < 1 || slot > 15) {
+			err << QObject::tr("Numéro de sauvegarde invalide : %1").arg(parser.value(slotOption)) << "\n";
+			return 1;
+		}
+		cli.setSlot(slot - 1);
+	}
+
+	if(parser.isSet(slotDirOption)) {
+		const QString slotDir = parser.value(slotDirOption);
+		if(slotDir != "1" && slotDir != "2") {
+			err << QObject::tr("Numéro de slot invalide : %1").arg(slotDir) << "\n";
+			return 1;
+		}
+		cli.setSlotDir(quint8(slotDir.toInt()));
+	}
+
+	if(parser.isSet(jobsOption)) {
+		int jobs = parser.value(jobsOption).toInt();
+		if(jobs > 0) {
+			QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+		}
+	} else if(cli.command() == HyneCli::Bench) {
+		// The timings are meaningless when the files are processed in parallel
+		QThreadPool::globalInstance()->setMaxThreadCount(1);
+	}
+
+	if(!cli.setLevel(parser.value(levelOption))) {
+		err << QObject::tr("Niveau de compression inconnu : %1").arg(parser.value(levelOption)) << "\n";
+		return 1;
+	}
+
+	if(parser.isSet(noSyncOption)) {
+		cli.setSyncPolicy(SavecardData::NoSync);
+	}
+
+	cli.setOutput(parser.value(outputOption));
+
+	if(cli.command() == HyneCli::Pack) {
+		if(!parser.isSet(outputOption)) {
+			err << QObject::tr("Veuillez préciser le fichier de destination (--output)") << "\n";
+			return 1;
+		}
+		HyneCli::Result result = cli.pack(args);
+		out << result.output;
+		err << result.errorString;
+		return result.ok ? 0 : 1;
+	}
+
+	// One file per worker, results printed in the order of the command line
+	QFuture<HyneCli::Result> future = QtConcurrent::mapped(args, cli);
+	bool ok = true;
+
+	for(int i = 0 ; i < args.size() ; ++i) {
+		HyneCli::Result result = future.resultAt(i);
+		out << result.output;
+		out.flush();
+		if(!result.ok) {
+			err << result.errorString;
+			if(!result.errorString.endsWith('\n')) {
+				err << "\n";
+			}
+			err.flush();
+			ok = false;
+		}
+	}
+
+	return ok ? 0 : 1;
+}
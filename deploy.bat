@@ -1,7 +1,8 @@
 @echo off
 
 set OUTPUT_DIR=deploy
-set EXE_PATH=release\hyne.exe
+set EXE_PATH=gui\release\hyne.exe
+set CLI_PATH=cli\release\hyne-cli.exe
 set LIB_DIR=%QTDIR%\bin
 set QT_TR_DIR=%QTDIR%\translations
 set LANGUAGES=en ja
@@ -23,6 +24,7 @@ for %%l in (%LANGUAGES%) do (
 
 rem Deploy Exe
 xcopy /y %EXE_PATH% %OUTPUT_DIR%
+xcopy /y %CLI_PATH% %OUTPUT_DIR%
 
 rem Compress Exe and DLLs. Note: DLLs in platforms/ directory should not be compressed.
 rem upx %OUTPUT_DIR%\*.dll %OUTPUT_DIR%\Hyne.exe
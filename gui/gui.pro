@@ -0,0 +1,129 @@
+TEMPLATE = app
+if(win32|macx) {
+    TARGET = Hyne
+} else {
+    TARGET = hyne
+}
+
+include(../hyne.pri)
+include(../libhyne/libhyne.pri)
+
+QT += core gui widgets concurrent
+
+# QTaskbarButton
+qtHaveModule(winextras) {
+    QT += winextras
+} else {
+    DEFINES += HYNE_TASKBAR_FAKE
+
+    win32 {
+        message(Hyne: Taskbar button overlay icon is only available with Qt Windows Extras)
+    }
+}
+
+# Input
+HEADERS += ../PageWidgets/ConfigEditor.h \
+    ../PageWidgets/MiscEditor.h \
+    ../PageWidgets/GfEditor.h \
+    ../PageWidgets/ItemEditor.h \
+    ../PageWidgets/PersoEditor.h \
+    ../PageWidgets/TTriadEditor.h \
+    ../PageWidgets/CWEditor.h \
+    ../PageWidgets/AllEditor.h \
+    ../Editor.h \
+    ../SCHeaderDialog.h \
+    ../SavecardWidget.h \
+    ../SaveIcon.h \
+    ../FF8Font.h \
+    ../Window.h \
+    ../HeaderDialog.h \
+    ../SpinBoxDelegate.h \
+    ../QHexEdit/qhexedit.h \
+    ../QHexEdit/qhexedit_p.h \
+    ../QHexEdit/xbytearray.h \
+    ../QHexEdit/commands.h \
+    ../PageWidgets/PageWidget.h \
+    ../PageWidgets/DrawPointEditor.h \
+    ../PageWidgets/BattleEditor.h \
+    ../PageWidgets/ShopEditor.h \
+    ../SelectSavesDialog.h \
+    ../PageWidgets/WorldmapEditor.h \
+    ../MapWidget.h \
+    ../PageWidgets/FieldEditor.h \
+    ../StartWidget.h \
+    ../PageWidgets/PartyEditor.h \
+    ../SavecardView.h \
+    ../QTaskbarButton.h \
+    ../PageWidgets/PreviewEditor.h \
+    ../TimeWidget.h \
+    ../HelpWidget.h \
+    ../MetadataDialog.h \
+    ../SpinBox.h
+SOURCES += ../PageWidgets/ConfigEditor.cpp \
+    ../PageWidgets/MiscEditor.cpp \
+    ../PageWidgets/GfEditor.cpp \
+    ../PageWidgets/ItemEditor.cpp \
+    ../PageWidgets/PersoEditor.cpp \
+    ../PageWidgets/TTriadEditor.cpp \
+    ../PageWidgets/CWEditor.cpp \
+    ../PageWidgets/AllEditor.cpp \
+    ../Editor.cpp \
+    ../SCHeaderDialog.cpp \
+    ../main.cpp \
+    ../SavecardWidget.cpp \
+    ../SaveIcon.cpp \
+    ../FF8Font.cpp \
+    ../Window.cpp \
+    ../HeaderDialog.cpp \
+    ../SpinBoxDelegate.cpp \
+    ../QHexEdit/qhexedit.cpp \
+    ../QHexEdit/qhexedit_p.cpp \
+    ../QHexEdit/xbytearray.cpp \
+    ../QHexEdit/commands.cpp \
+    ../PageWidgets/PageWidget.cpp \
+    ../PageWidgets/DrawPointEditor.cpp \
+    ../PageWidgets/BattleEditor.cpp \
+    ../PageWidgets/ShopEditor.cpp \
+    ../SelectSavesDialog.cpp \
+    ../PageWidgets/WorldmapEditor.cpp \
+    ../MapWidget.cpp \
+    ../PageWidgets/FieldEditor.cpp \
+    ../StartWidget.cpp \
+    ../PageWidgets/PartyEditor.cpp \
+    ../SavecardView.cpp \
+    ../PageWidgets/PreviewEditor.cpp \
+    ../TimeWidget.cpp \
+    ../HelpWidget.cpp \
+    ../MetadataDialog.cpp \
+    ../SpinBox.cpp
+RESOURCES += ../Hyne.qrc
+
+# Icons
+macx {
+    ICON = ../images/hyne.icns
+    QMAKE_INFO_PLIST = ../Hyne.plist
+    QMAKE_TARGET_BUNDLE_PREFIX = com.myst6re
+}
+win32 {
+    RC_ICONS = "../images/hyne.ico"
+    QMAKE_TARGET_COMPANY = "myst6re"
+    QMAKE_TARGET_DESCRIPTION = "Hyne FF8 Save Editor"
+    RC_LANG = 0x40C
+}
+
+# only on linux/unix (for package creation and other deploys)
+unix:!macx:!symbian {
+
+    target.path = /usr/bin
+
+    langfiles.files = ../*.qm
+    langfiles.path = /usr/share/hyne/
+
+    icon.files = ../images/Hyne.png
+    icon.path = /usr/share/pixmaps
+
+    desktop.files = ../Hyne.desktop
+    desktop.path = /usr/share/applications
+
+    INSTALLS += target langfiles icon desktop
+}
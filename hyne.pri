@@ -0,0 +1,21 @@
+# Settings shared by every target (see Hyne.pro)
+VERSION = 1.11.1
+
+DEFINES += PROGVERSION=$$VERSION PROGNAME=Hyne
+
+# include zlib
+!win32 {
+    LIBS += -lz
+} else {
+    exists($$[QT_INSTALL_PREFIX]/include/QtZlib) {
+        INCLUDEPATH += $$[QT_INSTALL_PREFIX]/include/QtZlib
+    } else {
+        # INCLUDEPATH += zlib
+        LIBS += -lz
+    }
+}
+
+win32 {
+    # Regedit features
+    LIBS += -ladvapi32 -lshell32
+}
@@ -0,0 +1,13 @@
+# Link with libhyne, include it in the .pro of the target
+INCLUDEPATH += $$PWD/..
+DEPENDPATH += $$PWD/..
+QT += concurrent
+
+win32:CONFIG(release, debug|release): LIBHYNE_DIR = $$OUT_PWD/../libhyne/release
+else:win32:CONFIG(debug, debug|release): LIBHYNE_DIR = $$OUT_PWD/../libhyne/debug
+else: LIBHYNE_DIR = $$OUT_PWD/../libhyne
+
+LIBS = -L$$LIBHYNE_DIR -lhyne $$LIBS
+
+win32-msvc*: PRE_TARGETDEPS += $$LIBHYNE_DIR/hyne.lib
+else: PRE_TARGETDEPS += $$LIBHYNE_DIR/libhyne.a
@@ -0,0 +1,53 @@
+# Formats, codecs and crypto of Hyne, without any GUI dependency
+TEMPLATE = lib
+TARGET = hyne
+CONFIG += staticlib
+
+include(../hyne.pri)
+
+QT = core concurrent
+
+HEADERS += ../Aes.h \
+    ../Config.h \
+    ../Crc16.h \
+    ../CryptographicHash.h \
+    ../Data.h \
+    ../FF8Installation.h \
+    ../FF8Text.h \
+    ../GZIP.h \
+    ../GZIPDevice.h \
+    ../LZS.h \
+    ../LZSDevice.h \
+    ../Metadata.h \
+    ../Parameters.h \
+    ../SaveData.h \
+    ../SaveFields.h \
+    ../SaveIconData.h \
+    ../SaveLocator.h \
+    ../SaveStore.h \
+    ../SavecardData.h \
+    ../Sha1.h \
+    ../UserDirectory.h
+SOURCES += ../Aes.cpp \
+    ../Config.cpp \
+    ../Crc16.cpp \
+    ../CryptographicHash.cpp \
+    ../Data.cpp \
+    ../FF8Installation.cpp \
+    ../FF8Text.cpp \
+    ../FF8text_caract.cpp \
+    ../GZIP.cpp \
+    ../GZIPDevice.cpp \
+    ../LZS.cpp \
+    ../LZSDevice.cpp \
+    ../Metadata.cpp \
+    ../SaveData.cpp \
+    ../SaveFields.cpp \
+    ../SaveIconData.cpp \
+    ../SaveLocator.cpp \
+    ../SaveStore.cpp \
+    ../SavecardData.cpp \
+    ../Sha1.cpp \
+    ../UserDirectory.cpp
+# Save state icon
+RESOURCES += libhyne.qrc